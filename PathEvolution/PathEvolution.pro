@@ -8,7 +8,7 @@ win32 {
     LIBS += -L"$$PWD/LabSFML/lib"
 }
 
-LIBS += -lsfml-graphics -lsfml-window -lsfml-system -lpthread
+LIBS += -lsfml-graphics -lsfml-window -lsfml-network -lsfml-system -lpthread
 
 SOURCES += main.cpp \
     window.cpp \
@@ -17,7 +17,26 @@ SOURCES += main.cpp \
     binaryselector.cpp \
     numericinput.cpp \
     weightedbinaryselector.cpp \
-    button.cpp
+    button.cpp \
+    threadpool.cpp \
+    population.cpp \
+    strategy.cpp \
+    parametercontrol.cpp \
+    random.cpp \
+    statistics.cpp \
+    islandevolver.cpp \
+    fitnesscache.cpp \
+    surrogate.cpp \
+    termination.cpp \
+    checkpoint.cpp \
+    cmaes.cpp \
+    localsearch.cpp \
+    remoteevaluation.cpp \
+    snapshotbuffer.cpp \
+    pathevaluator.cpp \
+    bezierbasis.cpp \
+    bezierkernel.cpp \
+    curvebatch.cpp
 
 HEADERS += \
     window.h \
@@ -26,6 +45,27 @@ HEADERS += \
     binaryselector.h \
     numericinput.h \
     weightedbinaryselector.h \
-    button.h
+    button.h \
+    threadpool.h \
+    population.h \
+    basicdifferentialevolver.h \
+    strategy.h \
+    parametercontrol.h \
+    random.h \
+    statistics.h \
+    islandevolver.h \
+    fitnesscache.h \
+    surrogate.h \
+    termination.h \
+    checkpoint.h \
+    optimizer.h \
+    cmaes.h \
+    localsearch.h \
+    remoteevaluation.h \
+    snapshotbuffer.h \
+    pathevaluator.h \
+    bezierbasis.h \
+    bezierkernel.h \
+    curvebatch.h
 
 QMAKE_CXXFLAGS += -O3 -pthread
@@ -0,0 +1,1259 @@
+#ifndef BASICDIFFERENTIALEVOLVER_H
+#define BASICDIFFERENTIALEVOLVER_H
+
+#include <vector>
+#include <functional>
+#include <utility>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "population.h"
+#include "threadpool.h"
+#include "strategy.h"
+#include "parametercontrol.h"
+#include "random.h"
+#include "statistics.h"
+#include "fitnesscache.h"
+#include "surrogate.h"
+#include "termination.h"
+#include "checkpoint.h"
+#include "optimizer.h"
+#include "localsearch.h"
+
+// Default evaluation of a block of trials: one direct call per row, which the
+// compiler can inline when Objective is a concrete callable type. Objectives
+// that evaluate whole blocks at once provide their own overload.
+template <class Objective>
+void evaluateTrials(const Objective& objective, GenomeMatrixView trials, double* fitnesses)
+{
+    for (unsigned int i = 0; i < trials.rows(); i++) {
+        fitnesses[i] = objective(trials.row(i));
+    }
+}
+
+// Strategies fixed at compile time ignore the parameter control's preference.
+template <class Strategy>
+void adaptStrategy(Strategy&, ParameterControl::Mode)
+{
+
+}
+
+// Differential evolution engine. Objective is any callable double(GenomeView)
+// and Strategy provides buildTrial(const TrialContext&, unsigned int) and
+// minimumPopSize(), such as Strategy<Rand1Mutation, BinomialCrossover>. Both are stored by value, so the
+// objective and the trial construction are inlined into the generation loop.
+// DifferentialEvolver is the type-erased instantiation.
+template <class Objective, class Strategy>
+class BasicDifferentialEvolver
+{
+public:
+    using Individual = std::vector<double>;
+    using ObjectiveFunction = ::ObjectiveFunction;
+    using BatchObjectiveFunction = ::BatchObjectiveFunction;
+    // Called on the evolving thread at the end of every generation.
+    using StatisticsCallback = std::function<void(const GenerationStatistics&)>;
+
+    BasicDifferentialEvolver(double crossoverRate, double scalingFactor,
+                             Objective objective = Objective(), Strategy strategy = Strategy());
+
+    void initialize(unsigned int popSize, unsigned int dimensionality,
+                    double min, double max, const Individual &prefix = Individual(), const Individual& suffix = Individual());
+
+    // Starts a new run for a changed problem from the old population instead
+    // of from scratch. The best retainedShare of the individuals are kept, the
+    // rest is drawn anew within the initialization bounds. The total number of
+    // genes stays the same, so if the new prefix/suffix lengths differ, genes
+    // are dropped from or drawn for the end of retained genomes. transform, if
+    // given, then receives the evolved genes of every retained genome to map
+    // them onto the new problem and repair them in place. Retained genomes are
+    // evaluated with the objective set at the next improve().
+    using GenomeTransform = std::function<void(double* genes, unsigned int count)>;
+    void replan(const Individual& prefix, const Individual& suffix, double retainedShare,
+                GenomeTransform transform = GenomeTransform());
+
+    // Every random decision of a run is drawn from a stream derived from this
+    // seed and the generation/individual it belongs to, so a run replays bit
+    // for bit for a given seed, whatever the number of threads. Takes effect
+    // at the next initialize().
+    void setSeed(std::uint64_t seed);
+    std::uint64_t getSeed() const;
+    unsigned long getGeneration() const;
+
+    // Anything Objective can be constructed from.
+    template <class Function>
+    void setObjectiveFunction(Function&& function) { objective = Objective(std::forward<Function>(function)); forgetEvaluations(); }
+    // Only for objectives that can hold a batch function.
+    void setBatchObjectiveFunction(BatchObjectiveFunction function) { objective = Objective::fromBatch(function); forgetEvaluations(); }
+    Objective& getObjective() { return objective; }
+
+    // Only for strategies that can be selected by name; returns false for unknown names.
+    bool setStrategy(const std::string& name) { return strategy.select(name); }
+    std::string getStrategy() const { return strategy.name(); }
+
+    // SHADE and LSHADE also switch a runtime strategy to DE/current-to-pbest/1/bin.
+    // The constructor's F and CR seed the jDE values and the SHADE memories.
+    void setParameterControl(ParameterControl::Mode mode);
+    ParameterControl::Mode getParameterControl() const;
+    // Total evaluations L-SHADE plans its population reduction for.
+    void setEvaluationBudget(unsigned long evaluations);
+    // Spreads the evaluation of every generation over threadCount threads (all
+    // cores for 0), a few blocks of rows per thread. Without it the objective
+    // gets each generation as a single block.
+    void setParallelEvaluation(bool enabled, unsigned int threadCount = 0);
+    bool isParallelEvaluation() const;
+    // Remembers the fitness of up to capacity genomes, quantized to resolution,
+    // and skips the objective for trials that fall on a remembered one. Cached
+    // trials still count as evaluations. A capacity of 0 disables the cache.
+    void setFitnessCache(std::size_t capacity, double resolution = 0);
+    const FitnessCache* getFitnessCache() const;
+    // Surrogate pre-screening for improve(): a k-NN model over the last
+    // capacity evaluated trials predicts every new trial, and trials predicted
+    // not to beat their target are dropped without evaluation. A share
+    // exactRate of those is evaluated anyway, which keeps the model fed with
+    // poor regions too and measures what the skipping costs. A capacity of 0
+    // disables it. Not used by evolveAsynchronously().
+    void setSurrogate(unsigned int capacity, unsigned int neighbours = 8, double exactRate = 0.1);
+    const SurrogateStatistics& getSurrogateStatistics() const;
+    // Does nothing once the run has finished.
+    void improve();
+    // Steady-state mode: the pool's workers repeatedly take the next target,
+    // build a trial from their own copy of the population, refreshed every
+    // popSize evaluations, evaluate it and replace the target under a
+    // per-slot lock, with no generation barrier.
+    // Every popSize evaluations count as one generation for parameter control
+    // and statistics. The external archive and L-SHADE reduction are not used,
+    // and the result depends on timing, so runs are not reproducible. Stops
+    // early when a termination criterion is met.
+    void evolveAsynchronously(unsigned long evaluations);
+
+    // Memetic refinement: every interval generations a Nelder-Mead search of
+    // at most budget evaluations starts from the best individual, with an
+    // initial simplex of step times the initialization range, and replaces it
+    // if it finds something better. Its evaluations count towards
+    // getEvaluations() and the budgets like any other, and are also reported
+    // in the local search statistics. An interval of 0 disables it.
+    void setLocalSearch(unsigned int interval, unsigned int budget, double step = 0.02);
+    const LocalSearchStatistics& getLocalSearchStatistics() const;
+
+    // Checked at the end of every generation. With Restart, stagnation and
+    // diversity collapse reinitialize everybody but the best individual and the
+    // run goes on; budgets always stop it. Restarts only happen in improve().
+    enum class TerminationAction { Stop, Restart };
+    void setTermination(const TerminationCriteria& criteria, TerminationAction action = TerminationAction::Stop);
+    bool isFinished() const;
+    TerminationReason getTerminationReason() const;
+    unsigned int getRestarts() const;
+
+    PopulationView getPopulation() const;
+    // The best individual is tracked during selection, so these are O(1).
+    GenomeView getBestIndividual() const;
+    unsigned int getBestIndex() const;
+    double getBestFitness() const;
+    double getFitness(unsigned int index) const;
+    unsigned long getEvaluations() const;
+
+    // Replaces the worst individual with genome if fitness is better; used for
+    // migration and other external seeding. Returns whether it was inserted.
+    bool replaceWorst(GenomeView genome, double fitness);
+
+    void setStatisticsCallback(StatisticsCallback callback);
+    const GenerationStatistics& getStatistics() const;
+
+    // Saves the state between two generations: population, fitnesses, the
+    // adaptive parameters, the archive, the seed and the counters. Random
+    // draws are derived from the seed and the generation, so that is all the
+    // random state there is. The objective, strategy, cache and surrogate are
+    // not saved. Both return false on failure; a failed load leaves the
+    // evolver untouched.
+    bool saveCheckpoint(const std::string& path) const;
+    // Maps the file and copies its arrays straight into the evolver. Also
+    // restores the parameter control mode, as setParameterControl() would.
+    bool loadCheckpoint(const std::string& path);
+
+private:
+    // Share of the population forming the p-best set of current-to-pbest/1.
+    static constexpr double PBestRate = 0.11;
+    // Archive capacity relative to the population size.
+    static constexpr double ArchiveRate = 2.6;
+    // L-SHADE never shrinks below this many individuals, nor below what the
+    // strategy needs to draw its donors.
+    static constexpr unsigned int MinimumPopSize = 4;
+
+    enum Stream : std::uint64_t {
+        InitializationStream,
+        ParameterStream,
+        TrialStream,
+        SelectionStream,
+        AsynchronousStream,
+        ScreeningStream,
+        RestartStream
+    };
+
+    // Evolved genes per individual; the fixed prefix and suffix are kept once,
+    // by the population, and only added back in the views objectives get.
+    unsigned int dimensionality;
+    double lowerBound;
+    double upperBound;
+    Population population;
+    Objective objective;
+    Strategy strategy;
+    ParameterControl parameterControl;
+
+    unsigned int bestIndex = 0;
+    double bestFitness = std::numeric_limits<double>::max() * -1;
+    unsigned int improvements = 0;
+    GenerationStatistics statistics;
+    StatisticsCallback statisticsCallback;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::uint64_t seed = Random::DefaultSeed;
+    Random selectionRandom;
+    unsigned int initialPopSize = 0;
+    unsigned long generation = 0;
+    unsigned long evaluations = 0;
+    unsigned long evaluationBudget = 0;
+    std::vector<unsigned int> ranking;
+    std::vector<double> archive;
+    unsigned int archiveSize = 0;
+
+    std::unique_ptr<ThreadPool> pool;
+    std::unique_ptr<FitnessCache> fitnessCache;
+
+    enum Screening : unsigned char {
+        Evaluate,
+        Skip,
+        Audit
+    };
+
+    std::unique_ptr<Surrogate> surrogate;
+    double exactRate = 0;
+    std::vector<unsigned char> screening;
+    SurrogateStatistics surrogateStatistics;
+
+    ConvergenceMonitor convergenceMonitor;
+    TerminationAction terminationAction = TerminationAction::Stop;
+    TerminationReason terminationReason = TerminationReason::None;
+    unsigned int restarts = 0;
+    unsigned int replans = 0;
+    unsigned int localSearchInterval = 0;
+    unsigned int localSearchBudget = 0;
+    double localSearchStep = 0;
+    LocalSearchStatistics localSearchStatistics;
+
+    // Leading individuals still to be evaluated before the next generation.
+    unsigned int pendingEvaluations = 0;
+    // Steady-state mode: one lock per population slot, and one for the shared
+    // bookkeeping (parameters, best, counters).
+    std::unique_ptr<std::atomic<bool>[]> slotLocks;
+    std::mutex controlMutex;
+
+    TrialContext makeTrialContext();
+    void findBest();
+    void evaluate(GenomeMatrixView trials, double* fitnesses);
+    void startRun();
+    void evaluatePending();
+    void forgetEvaluations();
+    void screen(unsigned int index);
+    void evaluateScreened(unsigned int first, unsigned int last);
+    void select(unsigned int index);
+    void accept(unsigned int index);
+    void endGeneration();
+    void publishStatistics();
+    void refineBest();
+    void checkTermination(bool restartAllowed);
+    void restart();
+    void lockSlot(unsigned int index);
+    void unlockSlot(unsigned int index);
+    void copySlot(unsigned int index, Population& snapshot);
+    void reducePopulation();
+};
+
+template <class Objective, class Strategy>
+constexpr double BasicDifferentialEvolver<Objective, Strategy>::PBestRate;
+template <class Objective, class Strategy>
+constexpr double BasicDifferentialEvolver<Objective, Strategy>::ArchiveRate;
+template <class Objective, class Strategy>
+constexpr unsigned int BasicDifferentialEvolver<Objective, Strategy>::MinimumPopSize;
+
+// Deduces the objective type, e.g. makeDifferentialEvolver<Strategy<Rand1Mutation, BinomialCrossover>>(0.9, 0.5, lambda).
+template <class Strategy, class Objective>
+BasicDifferentialEvolver<Objective, Strategy> makeDifferentialEvolver(double crossoverRate, double scalingFactor, Objective objective)
+{
+    return BasicDifferentialEvolver<Objective, Strategy>(crossoverRate, scalingFactor, objective);
+}
+
+template <class Objective, class Strategy>
+BasicDifferentialEvolver<Objective, Strategy>::BasicDifferentialEvolver(double crossoverRate, double scalingFactor,
+                                                                        Objective objective, Strategy strategy)
+    : objective(objective), strategy(strategy), parameterControl(crossoverRate, scalingFactor)
+{
+
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::initialize(unsigned int popSize, unsigned int dimensionality,
+                                     double min, double max, const Individual& prefix, const Individual& suffix)
+{
+    this->dimensionality = dimensionality - prefix.size() - suffix.size();
+    lowerBound = min;
+    upperBound = max;
+    population.resize(popSize, this->dimensionality);
+    population.setFixedGenes(prefix, suffix);
+    initialPopSize = popSize;
+    replans = 0;
+    startRun();
+
+    for (unsigned int i = 0; i < popSize; i++) {
+        Random random = Random::stream(seed, InitializationStream, 0, i);
+        random.fillUniform(population.genome(i), this->dimensionality, min, max);
+    }
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::replan(const Individual& prefix, const Individual& suffix,
+                                                           double retainedShare, GenomeTransform transform)
+{
+    unsigned int popSize = initialPopSize;
+    unsigned int total = dimensionality + population.getPrefix().size() + population.getSuffix().size();
+    unsigned int genes = total - prefix.size() - suffix.size();
+    unsigned int kept = std::min(genes, dimensionality);
+
+    std::vector<unsigned int> order(population.size());
+    for (unsigned int i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+        return population.fitness(a) > population.fitness(b);
+    });
+
+    double share = std::max(0.0, std::min(1.0, retainedShare));
+    unsigned int retained = std::min<unsigned int>(order.size(), std::round(share * popSize));
+
+    Population next;
+    next.resize(popSize, genes);
+    next.setFixedGenes(prefix, suffix);
+    replans++;
+
+    for (unsigned int i = 0; i < popSize; i++) {
+        double* genome = next.genome(i);
+        Random random = Random::stream(seed, InitializationStream, replans, i);
+
+        if (i < retained) {
+            const double* previous = population.genome(order[i]);
+            std::copy(previous, previous + kept, genome);
+            random.fillUniform(genome + kept, genes - kept, lowerBound, upperBound);
+            if (transform) {
+                transform(genome, genes);
+            }
+        } else {
+            random.fillUniform(genome, genes, lowerBound, upperBound);
+        }
+    }
+
+    population = std::move(next);
+    dimensionality = genes;
+    startRun();
+    // Unlike random individuals, retained ones are worth keeping until a
+    // trial beats them, so they get evaluated before the first generation.
+    pendingEvaluations = retained;
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::startRun()
+{
+    unsigned int popSize = population.size();
+    parameterControl.reset(popSize);
+    generation = 0;
+    evaluations = 0;
+    bestIndex = 0;
+    bestFitness = std::numeric_limits<double>::max() * -1;
+    statistics = GenerationStatistics();
+    startTime = std::chrono::steady_clock::now();
+    archiveSize = 0;
+    archive.clear();
+    screening.assign(popSize, Evaluate);
+    surrogateStatistics = SurrogateStatistics();
+    localSearchStatistics = LocalSearchStatistics();
+    convergenceMonitor.reset();
+    terminationReason = TerminationReason::None;
+    restarts = 0;
+    pendingEvaluations = 0;
+    forgetEvaluations();
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::evaluatePending()
+{
+    unsigned int count = pendingEvaluations;
+    pendingEvaluations = 0;
+
+    for (unsigned int i = 0; i < count; i++) {
+        std::copy(population.genome(i), population.genome(i) + dimensionality, population.trial(i));
+    }
+    evaluate(population.trialMatrix(0, count), &population.trialFitness(0));
+
+    for (unsigned int i = 0; i < count; i++) {
+        population.acceptTrial(i);
+    }
+    evaluations += count;
+    findBest();
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::setSeed(std::uint64_t seed)
+{
+    this->seed = seed;
+}
+
+template <class Objective, class Strategy>
+std::uint64_t BasicDifferentialEvolver<Objective, Strategy>::getSeed() const
+{
+    return seed;
+}
+
+template <class Objective, class Strategy>
+unsigned long BasicDifferentialEvolver<Objective, Strategy>::getGeneration() const
+{
+    return generation;
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::setParameterControl(ParameterControl::Mode mode)
+{
+    parameterControl.setMode(mode);
+    adaptStrategy(strategy, mode);
+}
+
+template <class Objective, class Strategy>
+ParameterControl::Mode BasicDifferentialEvolver<Objective, Strategy>::getParameterControl() const
+{
+    return parameterControl.getMode();
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::setEvaluationBudget(unsigned long evaluations)
+{
+    evaluationBudget = evaluations;
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::setParallelEvaluation(bool enabled, unsigned int threadCount)
+{
+    if (enabled) {
+        pool.reset(new ThreadPool(threadCount));
+    } else {
+        pool.reset();
+    }
+}
+
+template <class Objective, class Strategy>
+bool BasicDifferentialEvolver<Objective, Strategy>::isParallelEvaluation() const
+{
+    return pool != nullptr;
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::improve()
+{
+    if (isFinished()) {
+        return;
+    }
+
+    if (pendingEvaluations > 0) {
+        evaluatePending();
+    }
+
+    // Every trial is built from the same snapshot of the population, so the
+    // result of a generation does not depend on how it is evaluated.
+    TrialContext context = makeTrialContext();
+
+    for (unsigned int i = 0; i < population.size(); i++) {
+        Random random = Random::stream(seed, TrialStream, generation, i);
+        strategy.buildTrial(context, i, random);
+        screen(i);
+    }
+
+    if (pool) {
+        // A couple of blocks per thread leaves room for work stealing while
+        // still letting batch objectives amortize their setup.
+        unsigned int blocks = std::min(population.size(), pool->getThreadCount() * 2);
+        pool->parallelFor(blocks, [this, blocks](unsigned int block) {
+            unsigned int first = block * population.size() / blocks;
+            unsigned int last = (block + 1) * population.size() / blocks;
+            evaluateScreened(first, last);
+        });
+    } else {
+        evaluateScreened(0, population.size());
+    }
+
+    for (unsigned int i = 0; i < population.size(); i++) {
+        select(i);
+    }
+
+    endGeneration();
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::setFitnessCache(std::size_t capacity, double resolution)
+{
+    if (capacity > 0) {
+        fitnessCache.reset(new FitnessCache(capacity, resolution));
+    } else {
+        fitnessCache.reset();
+    }
+}
+
+template <class Objective, class Strategy>
+const FitnessCache* BasicDifferentialEvolver<Objective, Strategy>::getFitnessCache() const
+{
+    return fitnessCache.get();
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::forgetEvaluations()
+{
+    if (fitnessCache) {
+        fitnessCache->clear();
+    }
+    if (surrogate) {
+        surrogate->clear();
+    }
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::setSurrogate(unsigned int capacity, unsigned int neighbours, double exactRate)
+{
+    if (capacity > 0) {
+        surrogate.reset(new Surrogate(capacity, neighbours));
+    } else {
+        surrogate.reset();
+    }
+
+    this->exactRate = exactRate;
+    screening.assign(population.size(), Evaluate);
+    surrogateStatistics = SurrogateStatistics();
+}
+
+template <class Objective, class Strategy>
+const SurrogateStatistics& BasicDifferentialEvolver<Objective, Strategy>::getSurrogateStatistics() const
+{
+    return surrogateStatistics;
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::screen(unsigned int index)
+{
+    screening[index] = Evaluate;
+
+    double predicted;
+    if (!surrogate || !surrogate->predict(population.trialView(index).genes(), predicted) ||
+        predicted > population.fitness(index)) {
+        return;
+    }
+
+    Random random = Random::stream(seed, ScreeningStream, generation, index);
+    if (random.uniform() < exactRate) {
+        screening[index] = Audit;
+    } else {
+        screening[index] = Skip;
+        surrogateStatistics.skipped++;
+    }
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::evaluateScreened(unsigned int first, unsigned int last)
+{
+    while (first < last) {
+        if (screening[first] == Skip) {
+            first++;
+            continue;
+        }
+
+        unsigned int end = first + 1;
+        while (end < last && screening[end] != Skip) {
+            end++;
+        }
+
+        evaluate(population.trialMatrix(first, end - first), &population.trialFitness(first));
+        first = end;
+    }
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::select(unsigned int index)
+{
+    if (screening[index] == Skip) {
+        return;
+    }
+
+    evaluations++;
+    bool improved = population.trialFitness(index) > population.fitness(index);
+
+    if (surrogate) {
+        surrogate->add(population.trialView(index).genes(), population.trialFitness(index));
+
+        if (screening[index] == Audit) {
+            surrogateStatistics.audited++;
+            if (improved) {
+                surrogateStatistics.wrongRejections++;
+                surrogateStatistics.lostFitness += population.trialFitness(index) - population.fitness(index);
+            }
+        }
+    }
+
+    if (improved) {
+        accept(index);
+    }
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::evaluate(GenomeMatrixView trials, double* fitnesses)
+{
+    if (!fitnessCache) {
+        evaluateTrials(objective, trials, fitnesses);
+        return;
+    }
+
+    // Consecutive misses are handed to the objective as one block, so batch
+    // objectives keep working on runs of rows.
+    unsigned int row = 0;
+    while (row < trials.rows()) {
+        if (fitnessCache->lookup(trials.row(row).genes(), fitnesses[row])) {
+            row++;
+            continue;
+        }
+
+        unsigned int first = row++;
+        while (row < trials.rows() && !fitnessCache->lookup(trials.row(row).genes(), fitnesses[row])) {
+            row++;
+        }
+        unsigned int last = row;
+
+        evaluateTrials(objective, trials.slice(first, last - first), fitnesses + first);
+        for (unsigned int i = first; i < last; i++) {
+            fitnessCache->insert(trials.row(i).genes(), fitnesses[i]);
+        }
+
+        // The run ended on a hit, which already has its fitness.
+        if (row < trials.rows()) {
+            row++;
+        }
+    }
+}
+
+template <class Objective, class Strategy>
+TrialContext BasicDifferentialEvolver<Objective, Strategy>::makeTrialContext()
+{
+    Random parameterRandom = Random::stream(seed, ParameterStream, generation);
+    parameterControl.sample(parameterRandom);
+    selectionRandom = Random::stream(seed, SelectionStream, generation);
+
+    ranking.resize(population.size());
+    for (unsigned int i = 0; i < ranking.size(); i++) {
+        ranking[i] = i;
+    }
+    std::sort(ranking.begin(), ranking.end(), [this](unsigned int a, unsigned int b) {
+        return population.fitness(a) > population.fitness(b);
+    });
+
+    TrialContext context;
+    context.population = &population;
+    context.begin = 0;
+    context.end = dimensionality;
+    context.best = bestIndex;
+    context.scalingFactors = parameterControl.getScalingFactors();
+    context.crossoverRates = parameterControl.getCrossoverRates();
+    context.ranking = ranking.data();
+    context.pBestCount = std::max(2u, static_cast<unsigned int>(std::round(PBestRate * population.size())));
+    context.archive = archive.data();
+    context.archiveSize = archiveSize;
+    return context;
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::findBest()
+{
+    bestIndex = 0;
+    for (unsigned int i = 1; i < population.size(); i++) {
+        if (population.fitness(i) > population.fitness(bestIndex)) {
+            bestIndex = i;
+        }
+    }
+    bestFitness = population.fitness(bestIndex);
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::evolveAsynchronously(unsigned long budget)
+{
+    if (isFinished()) {
+        return;
+    }
+
+    if (pendingEvaluations > 0) {
+        evaluatePending();
+    }
+
+    unsigned int popSize = population.size();
+    unsigned int workers = pool ? pool->getThreadCount() : 1;
+    std::atomic<unsigned long> tickets(0);
+    // Streams are keyed by the run's evaluation count, so later calls do not
+    // replay the draws of earlier ones.
+    unsigned long firstEvaluation = evaluations;
+
+    slotLocks.reset(new std::atomic<bool>[popSize]);
+    for (unsigned int i = 0; i < popSize; i++) {
+        slotLocks[i].store(false);
+    }
+
+    Random parameterRandom = Random::stream(seed, ParameterStream, generation);
+    parameterControl.sample(parameterRandom);
+
+    auto work = [&](unsigned int) {
+        Population snapshot;
+        snapshot.resize(popSize, dimensionality);
+        snapshot.setFixedGenes(population.getPrefix(), population.getSuffix());
+        std::vector<double> scalingFactors(popSize);
+        std::vector<double> crossoverRates(popSize);
+        std::vector<unsigned int> order(popSize);
+
+        TrialContext context;
+        context.population = &snapshot;
+        context.begin = 0;
+        context.end = dimensionality;
+        context.scalingFactors = scalingFactors.data();
+        context.crossoverRates = crossoverRates.data();
+        context.ranking = order.data();
+        context.pBestCount = std::max(2u, static_cast<unsigned int>(std::round(PBestRate * popSize)));
+        context.archive = nullptr;
+        context.archiveSize = 0;
+        unsigned long refreshed = std::numeric_limits<unsigned long>::max();
+
+        while (true) {
+            unsigned long ticket = tickets++;
+            if (ticket >= budget) {
+                break;
+            }
+            unsigned int target = ticket % popSize;
+
+            // The whole copy and the ranking are refreshed once per virtual
+            // generation, the target on every ticket, which keeps the cost
+            // per evaluation at O(D) amortized.
+            if (ticket / popSize != refreshed) {
+                refreshed = ticket / popSize;
+                for (unsigned int i = 0; i < popSize; i++) {
+                    copySlot(i, snapshot);
+                    order[i] = i;
+                }
+                std::sort(order.begin(), order.end(), [&snapshot](unsigned int a, unsigned int b) {
+                    return snapshot.fitness(a) > snapshot.fitness(b);
+                });
+                context.best = order.front();
+            } else {
+                copySlot(target, snapshot);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(controlMutex);
+                if (isFinished()) {
+                    break;
+                }
+                scalingFactors[target] = parameterControl.getScalingFactors()[target];
+                crossoverRates[target] = parameterControl.getCrossoverRates()[target];
+            }
+
+            Random random = Random::stream(seed, AsynchronousStream, firstEvaluation + ticket);
+            strategy.buildTrial(context, target, random);
+            evaluate(snapshot.trialMatrix(target, 1), &snapshot.trialFitness(target));
+
+            double trialFitness = snapshot.trialFitness(target);
+            double previous;
+            bool accepted = false;
+
+            lockSlot(target);
+            previous = population.fitness(target);
+            if (trialFitness > previous) {
+                std::copy(snapshot.trial(target), snapshot.trial(target) + dimensionality, population.genome(target));
+                population.fitness(target) = trialFitness;
+                accepted = true;
+            }
+            unlockSlot(target);
+
+            std::lock_guard<std::mutex> lock(controlMutex);
+            evaluations++;
+
+            if (accepted) {
+                bool evaluated = previous != std::numeric_limits<double>::max() * -1;
+                parameterControl.reportSuccess(target, evaluated ? trialFitness - previous : 0);
+                improvements++;
+
+                if (trialFitness > bestFitness) {
+                    bestIndex = target;
+                    bestFitness = trialFitness;
+                }
+            }
+
+            if ((ticket + 1) % popSize == 0) {
+                parameterControl.update();
+                generation++;
+                parameterRandom = Random::stream(seed, ParameterStream, generation);
+                parameterControl.sample(parameterRandom);
+                // Measured on the live population, which the other workers
+                // keep changing while a snapshot ages.
+                for (unsigned int i = 0; i < popSize; i++) {
+                    lockSlot(i);
+                }
+                publishStatistics();
+                for (unsigned int i = 0; i < popSize; i++) {
+                    unlockSlot(i);
+                }
+                checkTermination(false);
+            }
+        }
+    };
+
+    if (pool) {
+        pool->parallelFor(workers, work);
+    } else {
+        work(0);
+    }
+
+    slotLocks.reset();
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::lockSlot(unsigned int index)
+{
+    while (slotLocks[index].exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::unlockSlot(unsigned int index)
+{
+    slotLocks[index].store(false, std::memory_order_release);
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::copySlot(unsigned int index, Population& snapshot)
+{
+    lockSlot(index);
+    std::copy(population.genome(index), population.genome(index) + dimensionality, snapshot.genome(index));
+    snapshot.fitness(index) = population.fitness(index);
+    unlockSlot(index);
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::accept(unsigned int index)
+{
+    // Parents that were never evaluated carry the lowest fitness; their
+    // replacement says nothing about how good the parameters were.
+    bool evaluated = population.fitness(index) != std::numeric_limits<double>::max() * -1;
+    double improvement = evaluated ? population.trialFitness(index) - population.fitness(index) : 0;
+    parameterControl.reportSuccess(index, improvement);
+
+    if (parameterControl.usesArchive()) {
+        unsigned int capacity = std::round(ArchiveRate * population.size());
+        unsigned int stride = population.getStride();
+        unsigned int slot = archiveSize < capacity ? archiveSize++ : selectionRandom.index(capacity);
+
+        archive.resize(static_cast<std::size_t>(std::max(archiveSize, capacity)) * stride);
+        std::copy(population.genome(index), population.genome(index) + dimensionality, archive.begin() + slot * stride);
+    }
+
+    population.acceptTrial(index);
+    improvements++;
+
+    if (population.fitness(index) > bestFitness) {
+        bestIndex = index;
+        bestFitness = population.fitness(index);
+    }
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::endGeneration()
+{
+    parameterControl.update();
+    generation++;
+
+    if (parameterControl.getMode() == ParameterControl::Mode::LSHADE && evaluationBudget > 0) {
+        reducePopulation();
+    }
+
+    if (localSearchInterval > 0 && generation % localSearchInterval == 0) {
+        refineBest();
+    }
+
+    publishStatistics();
+    checkTermination(true);
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::publishStatistics()
+{
+    statistics.generation = generation;
+    statistics.improvements = improvements;
+    statistics.evaluations = evaluations;
+    statistics.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    statistics.measure(population, 0, dimensionality, bestFitness);
+    improvements = 0;
+
+    if (statisticsCallback) {
+        statisticsCallback(statistics);
+    }
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::refineBest()
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    // The trial row of the best individual is free between generations and
+    // serves as scratch space, so candidates reach the objective like any
+    // other trial. They skip the fitness cache, though: once the simplex is
+    // smaller than its resolution, it would only return the fitness of
+    // neighbouring vertices.
+    unsigned int index = bestIndex;
+    double* scratch = population.trial(index);
+    std::vector<double> point(population.genome(index), population.genome(index) + dimensionality);
+
+    NelderMead search(dimensionality, localSearchStep * (upperBound - lowerBound));
+    double fitness = search.maximize([this, index, scratch](const double* genes) {
+        std::copy(genes, genes + dimensionality, scratch);
+        double value;
+        evaluateTrials(objective, population.trialMatrix(index, 1), &value);
+        return value;
+    }, point.data(), bestFitness, localSearchBudget);
+
+    evaluations += search.getEvaluations();
+    localSearchStatistics.runs++;
+    localSearchStatistics.evaluations += search.getEvaluations();
+
+    if (fitness > bestFitness) {
+        localSearchStatistics.improvements++;
+        localSearchStatistics.gain += fitness - bestFitness;
+        std::copy(point.begin(), point.end(), population.genome(index));
+        population.fitness(index) = fitness;
+        bestFitness = fitness;
+    }
+
+    localSearchStatistics.wallTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::checkTermination(bool restartAllowed)
+{
+    TerminationReason reason = convergenceMonitor.update(statistics);
+    if (reason == TerminationReason::None) {
+        return;
+    }
+
+    bool restartable = reason == TerminationReason::Stagnation || reason == TerminationReason::DiversityCollapse;
+    if (restartAllowed && restartable && terminationAction == TerminationAction::Restart) {
+        restart();
+    } else {
+        terminationReason = reason;
+    }
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::restart()
+{
+    restarts++;
+
+    for (unsigned int i = 0; i < population.size(); i++) {
+        if (i == bestIndex) {
+            continue;
+        }
+
+        Random random = Random::stream(seed, RestartStream, restarts, i);
+        random.fillUniform(population.genome(i), dimensionality, lowerBound, upperBound);
+        population.fitness(i) = std::numeric_limits<double>::max() * -1;
+    }
+
+    parameterControl.reset(population.size());
+    archiveSize = 0;
+    convergenceMonitor.reset();
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::reducePopulation()
+{
+    unsigned int minimum = std::max(MinimumPopSize, strategy.minimumPopSize());
+    double progress = std::min(1.0, static_cast<double>(evaluations) / evaluationBudget);
+    unsigned int target = std::round(initialPopSize + (minimum - static_cast<double>(initialPopSize)) * progress);
+    target = std::max(minimum, target);
+
+    if (target >= population.size()) {
+        return;
+    }
+
+    std::vector<unsigned int> kept(population.size());
+    for (unsigned int i = 0; i < kept.size(); i++) {
+        kept[i] = i;
+    }
+    std::sort(kept.begin(), kept.end(), [this](unsigned int a, unsigned int b) {
+        return population.fitness(a) > population.fitness(b);
+    });
+    kept.resize(target);
+    std::sort(kept.begin(), kept.end());
+
+    population.retain(kept);
+    parameterControl.retain(kept);
+    findBest();
+
+    unsigned int capacity = std::round(ArchiveRate * population.size());
+    archiveSize = std::min(archiveSize, capacity);
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::setLocalSearch(unsigned int interval, unsigned int budget, double step)
+{
+    localSearchInterval = interval;
+    localSearchBudget = budget;
+    localSearchStep = step;
+}
+
+template <class Objective, class Strategy>
+const LocalSearchStatistics& BasicDifferentialEvolver<Objective, Strategy>::getLocalSearchStatistics() const
+{
+    return localSearchStatistics;
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::setTermination(const TerminationCriteria& criteria, TerminationAction action)
+{
+    convergenceMonitor = ConvergenceMonitor(criteria);
+    terminationAction = action;
+}
+
+template <class Objective, class Strategy>
+bool BasicDifferentialEvolver<Objective, Strategy>::isFinished() const
+{
+    return terminationReason != TerminationReason::None;
+}
+
+template <class Objective, class Strategy>
+TerminationReason BasicDifferentialEvolver<Objective, Strategy>::getTerminationReason() const
+{
+    return terminationReason;
+}
+
+template <class Objective, class Strategy>
+unsigned int BasicDifferentialEvolver<Objective, Strategy>::getRestarts() const
+{
+    return restarts;
+}
+
+template <class Objective, class Strategy>
+bool BasicDifferentialEvolver<Objective, Strategy>::saveCheckpoint(const std::string& path) const
+{
+    unsigned int popSize = population.size();
+    unsigned int stride = population.getStride();
+
+    CheckpointHeader header;
+    header.seed = seed;
+    header.generation = generation;
+    header.evaluations = evaluations;
+    header.popSize = popSize;
+    header.initialPopSize = initialPopSize;
+    header.dimensionality = dimensionality;
+    header.stride = stride;
+    header.prefixLength = population.getPrefix().size();
+    header.suffixLength = population.getSuffix().size();
+    header.parameterMode = static_cast<std::uint32_t>(parameterControl.getMode());
+    header.memorySize = parameterControl.getMemorySize();
+    header.memoryIndex = parameterControl.getMemoryIndex();
+    header.archiveSize = archiveSize;
+    header.restarts = restarts;
+    header.lowerBound = lowerBound;
+    header.upperBound = upperBound;
+
+    std::size_t perIndividual = popSize * sizeof(double);
+    std::size_t perMemory = header.memorySize * sizeof(double);
+
+    return writeCheckpoint(path, header, {
+        {population.genome(0), static_cast<std::size_t>(popSize) * stride * sizeof(double)},
+        {population.fitnessData(), perIndividual},
+        {parameterControl.getScalingFactors(), perIndividual},
+        {parameterControl.getCrossoverRates(), perIndividual},
+        {parameterControl.getAcceptedScalingFactors(), perIndividual},
+        {parameterControl.getAcceptedCrossoverRates(), perIndividual},
+        {parameterControl.getScalingMemory(), perMemory},
+        {parameterControl.getCrossoverMemory(), perMemory},
+        {archive.data(), static_cast<std::size_t>(archiveSize) * stride * sizeof(double)},
+        {population.getPrefix().data(), header.prefixLength * sizeof(double)},
+        {population.getSuffix().data(), header.suffixLength * sizeof(double)}
+    });
+}
+
+template <class Objective, class Strategy>
+bool BasicDifferentialEvolver<Objective, Strategy>::loadCheckpoint(const std::string& path)
+{
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    CheckpointReader reader(file);
+    const CheckpointHeader* header = reader.header();
+    if (header == nullptr || header->popSize == 0 || header->memorySize != parameterControl.getMemorySize() ||
+        header->parameterMode > static_cast<std::uint32_t>(ParameterControl::Mode::LSHADE) ||
+        header->dimensionality == 0 || header->initialPopSize < header->popSize) {
+        return false;
+    }
+
+    // Every size below comes from the header, so the file has to be exactly
+    // as long as it claims before anything is allocated from it.
+    unsigned int popSize = header->popSize;
+    std::uint64_t stride = header->stride;
+    if (stride != Population::strideFor(header->dimensionality) ||
+        file.size() != checkpointSize({popSize * stride, popSize, popSize, popSize, popSize, popSize,
+                                       header->memorySize, header->memorySize, header->archiveSize * stride,
+                                       header->prefixLength, header->suffixLength})) {
+        return false;
+    }
+
+    Population restored;
+    restored.resize(popSize, header->dimensionality);
+
+    std::size_t rows = static_cast<std::size_t>(popSize) * header->stride;
+    const double* genomes = reader.take(rows);
+    const double* fitnesses = reader.take(popSize);
+    const double* scalingFactors = reader.take(popSize);
+    const double* crossoverRates = reader.take(popSize);
+    const double* acceptedScalingFactors = reader.take(popSize);
+    const double* acceptedCrossoverRates = reader.take(popSize);
+    const double* scalingMemory = reader.take(header->memorySize);
+    const double* crossoverMemory = reader.take(header->memorySize);
+    const double* archived = reader.take(static_cast<std::size_t>(header->archiveSize) * header->stride);
+    const double* prefix = reader.take(header->prefixLength);
+    const double* suffix = reader.take(header->suffixLength);
+    if (suffix == nullptr || !reader.atEnd()) {
+        return false;
+    }
+
+    std::copy(genomes, genomes + rows, restored.genome(0));
+    std::copy(fitnesses, fitnesses + popSize, &restored.fitness(0));
+    restored.setFixedGenes(std::vector<double>(prefix, prefix + header->prefixLength),
+                           std::vector<double>(suffix, suffix + header->suffixLength));
+    population = std::move(restored);
+
+    setParameterControl(static_cast<ParameterControl::Mode>(header->parameterMode));
+    parameterControl.restore(popSize, scalingFactors, crossoverRates, acceptedScalingFactors, acceptedCrossoverRates,
+                             header->memoryIndex, scalingMemory, crossoverMemory);
+
+    unsigned int capacity = std::round(ArchiveRate * popSize);
+    archiveSize = header->archiveSize;
+    archive.assign(archived, archived + static_cast<std::size_t>(archiveSize) * header->stride);
+    archive.resize(static_cast<std::size_t>(std::max(archiveSize, capacity)) * header->stride);
+
+    seed = header->seed;
+    generation = header->generation;
+    evaluations = header->evaluations;
+    initialPopSize = header->initialPopSize;
+    dimensionality = header->dimensionality;
+    lowerBound = header->lowerBound;
+    upperBound = header->upperBound;
+    restarts = header->restarts;
+
+    // Whatever the evolver was doing before belongs to another run.
+    pendingEvaluations = 0;
+    improvements = 0;
+    replans = 0;
+    localSearchStatistics = LocalSearchStatistics();
+    surrogateStatistics = SurrogateStatistics();
+    screening.assign(popSize, Evaluate);
+    forgetEvaluations();
+    statistics = GenerationStatistics();
+    startTime = std::chrono::steady_clock::now();
+    convergenceMonitor.reset();
+    terminationReason = TerminationReason::None;
+    findBest();
+    return true;
+}
+
+template <class Objective, class Strategy>
+PopulationView BasicDifferentialEvolver<Objective, Strategy>::getPopulation() const
+{
+    return PopulationView(population);
+}
+
+template <class Objective, class Strategy>
+GenomeView BasicDifferentialEvolver<Objective, Strategy>::getBestIndividual() const
+{
+    return population.genomeView(bestIndex);
+}
+
+template <class Objective, class Strategy>
+unsigned int BasicDifferentialEvolver<Objective, Strategy>::getBestIndex() const
+{
+    return bestIndex;
+}
+
+template <class Objective, class Strategy>
+double BasicDifferentialEvolver<Objective, Strategy>::getBestFitness() const
+{
+    return bestFitness;
+}
+
+template <class Objective, class Strategy>
+double BasicDifferentialEvolver<Objective, Strategy>::getFitness(unsigned int index) const
+{
+    return population.fitness(index);
+}
+
+template <class Objective, class Strategy>
+unsigned long BasicDifferentialEvolver<Objective, Strategy>::getEvaluations() const
+{
+    return evaluations;
+}
+
+template <class Objective, class Strategy>
+void BasicDifferentialEvolver<Objective, Strategy>::setStatisticsCallback(StatisticsCallback callback)
+{
+    statisticsCallback = callback;
+}
+
+template <class Objective, class Strategy>
+const GenerationStatistics& BasicDifferentialEvolver<Objective, Strategy>::getStatistics() const
+{
+    return statistics;
+}
+
+template <class Objective, class Strategy>
+bool BasicDifferentialEvolver<Objective, Strategy>::replaceWorst(GenomeView genome, double fitness)
+{
+    unsigned int worst = 0;
+    for (unsigned int i = 1; i < population.size(); i++) {
+        if (population.fitness(i) < population.fitness(worst)) {
+            worst = i;
+        }
+    }
+
+    if (fitness <= population.fitness(worst)) {
+        return false;
+    }
+
+    // genome comes whole, fixed genes included.
+    unsigned int prefixLength = population.getPrefix().size();
+    for (unsigned int j = 0; j < dimensionality; j++) {
+        population.genome(worst)[j] = genome[prefixLength + j];
+    }
+    population.fitness(worst) = fitness;
+
+    if (fitness > bestFitness) {
+        bestIndex = worst;
+        bestFitness = fitness;
+    }
+
+    return true;
+}
+
+#endif // BASICDIFFERENTIALEVOLVER_H
@@ -0,0 +1,32 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = bench
+INCLUDEPATH += ..
+
+LIBS += -lpthread
+
+SOURCES += main.cpp \
+    enginebench.cpp \
+    donorbench.cpp \
+    bezierbench.cpp \
+    ../differentialevolver.cpp \
+    ../threadpool.cpp \
+    ../population.cpp \
+    ../strategy.cpp \
+    ../parametercontrol.cpp \
+    ../random.cpp \
+    ../statistics.cpp \
+    ../fitnesscache.cpp \
+    ../surrogate.cpp \
+    ../termination.cpp \
+    ../checkpoint.cpp \
+    ../localsearch.cpp \
+    ../bezierbasis.cpp
+
+HEADERS += \
+    benchmark.h
+
+QMAKE_CXXFLAGS += -O3 -pthread
@@ -0,0 +1,23 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+
+// Best wall time of repetitions runs of body, in seconds. The best rather
+// than the mean keeps scheduler noise out of small timings.
+double measure(unsigned int repetitions, const std::function<void()>& body);
+
+// Sphere function, NP=50, D=30, 2000 generations, through DifferentialEvolver
+// and through BasicDifferentialEvolver with the objective and strategy inlined.
+void runEngineBenchmark();
+
+// Picking the three donors of DE/rand/1 from 50 individuals, the target
+// excluded: the unordered_set selection DE used before, the same rejection
+// sampler on the old mt19937, and Random::sampleDistinct().
+void runDonorBenchmark();
+
+// Sampling 16 control point curves at 201 parameters: the memoized
+// Util::bezierCurve that user-023 replaced against BezierBasis::sample().
+void runBezierBenchmark();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,109 @@
+#include "benchmark.h"
+#include "bezierbasis.h"
+#include "random.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+    const unsigned int points = 16;
+    const unsigned int samples = 201;
+    const unsigned int curves = 2000;
+
+    using Point2D = std::pair<double, double>;
+
+    // Util::bezierCurve as it was before user-023: every coefficient looked
+    // up in a memo keyed on the control point and the floating-point t.
+    std::unordered_map<int, std::unordered_map<double, double>> bezierMemo;
+
+    double factorial(double n)
+    {
+        double result = 1;
+        for (int i = 2; i <= n; i++) {
+            result *= i;
+        }
+        return result;
+    }
+
+    double binomialCoefficient(unsigned int n, unsigned int k)
+    {
+        return factorial(n) / (factorial(k) * (factorial(n - k)));
+    }
+
+    Point2D bezierCurve(double t, const std::vector<Point2D> points)
+    {
+        int n = points.size() - 1;
+        Point2D point(0, 0);
+
+        for (int i = 0; i <= n; i++) {
+            double c;
+            if (bezierMemo.find(i) != bezierMemo.end()) {
+                if (bezierMemo[i].find(t) != bezierMemo[i].end()) {
+                    c = bezierMemo[i][t];
+                } else {
+                    c = binomialCoefficient(n, i) * std::pow(1 - t, n - i) * std::pow(t, i);
+                    bezierMemo[i][t] = c;
+                }
+            } else {
+                c = binomialCoefficient(n, i) * std::pow(1 - t, n - i) * std::pow(t, i);
+                bezierMemo[i] = std::unordered_map<double, double>();
+                bezierMemo[i][t] = c;
+            }
+
+            point.first += points[i].first * c;
+            point.second += points[i].second * c;
+        }
+
+        return point;
+    }
+}
+
+void runBezierBenchmark()
+{
+    Random random(1);
+    std::vector<double> controls(curves * 2 * points);
+    for (double& value : controls) {
+        value = random.uniform();
+    }
+
+    std::shared_ptr<const BezierBasis> basis = BezierBasis::uniform(points - 1, samples);
+    std::vector<double> memoPoints(curves * 2 * samples);
+    std::vector<double> tablePoints(curves * 2 * samples);
+
+    double memo = measure(3, [&]() {
+        for (unsigned int curve = 0; curve < curves; curve++) {
+            const double* genome = controls.data() + curve * 2 * points;
+            std::vector<Point2D> curvePoints;
+            for (unsigned int i = 0; i < points; i++) {
+                curvePoints.push_back({genome[2 * i], genome[2 * i + 1]});
+            }
+
+            double* xs = memoPoints.data() + curve * 2 * samples;
+            for (unsigned int sample = 0; sample < samples; sample++) {
+                Point2D point = bezierCurve(basis->getParameter(sample), curvePoints);
+                xs[sample] = point.first;
+                xs[samples + sample] = point.second;
+            }
+        }
+    });
+
+    double table = measure(3, [&]() {
+        for (unsigned int curve = 0; curve < curves; curve++) {
+            double* xs = tablePoints.data() + curve * 2 * samples;
+            basis->sample(GenomeView(controls.data() + curve * 2 * points, 2 * points), xs, xs + samples);
+        }
+    });
+
+    double difference = 0;
+    for (unsigned int i = 0; i < memoPoints.size(); i++) {
+        difference = std::max(difference, std::abs(memoPoints[i] - tablePoints[i]));
+    }
+
+    std::printf("%u control points, %u samples, %u curves (largest difference %.1e)\n",
+                points, samples, curves, difference);
+    std::printf("memoized Util::bezierCurve  %6.2f us per curve\n", memo / curves * 1e6);
+    std::printf("BezierBasis::sample         %6.2f us per curve\n", table / curves * 1e6);
+}
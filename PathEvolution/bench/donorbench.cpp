@@ -0,0 +1,84 @@
+#include "benchmark.h"
+#include "random.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <unordered_set>
+
+namespace {
+    const unsigned int popSize = 50;
+    const unsigned int draws = 2000000;
+
+    // The donor selection DE used before user-007: Util::irandom() on a
+    // shared mt19937 and two unordered_sets per draw.
+    std::mt19937 generator;
+
+    int roundedRandom(double min, double max)
+    {
+        std::uniform_real_distribution<double> distribution(min, max);
+        return std::round(distribution(generator));
+    }
+
+    std::unordered_set<unsigned int> chooseRandomlyRestricted(unsigned int max, unsigned int quantity,
+                                                              std::unordered_set<unsigned int> restricted)
+    {
+        std::unordered_set<unsigned int> values;
+        while (values.size() != quantity) {
+            unsigned int element = roundedRandom(0, max - 1);
+            if (values.find(element) == values.end() && restricted.find(element) == restricted.end()) {
+                values.insert(element);
+            }
+        }
+
+        return values;
+    }
+
+    // Rejection into a fixed array, still on the mt19937, as user-007 left it.
+    void sampleDistinctMersenne(unsigned int max, unsigned int quantity, unsigned int excluded, unsigned int* out)
+    {
+        std::uniform_real_distribution<double> distribution(0, max);
+        unsigned int drawn = 0;
+        while (drawn < quantity) {
+            unsigned int element = std::min<unsigned int>(distribution(generator), max - 1);
+            if (element != excluded && std::find(out, out + drawn, element) == out + drawn) {
+                out[drawn++] = element;
+            }
+        }
+    }
+}
+
+void runDonorBenchmark()
+{
+    unsigned long checksum = 0;
+
+    double sets = measure(3, [&checksum]() {
+        for (unsigned int i = 0; i < draws; i++) {
+            std::unordered_set<unsigned int> agents = chooseRandomlyRestricted(popSize, 3, {i % popSize});
+            std::vector<unsigned int> donors(agents.begin(), agents.end());
+            checksum += donors[0];
+        }
+    });
+
+    double mersenne = measure(3, [&checksum]() {
+        unsigned int donors[3];
+        for (unsigned int i = 0; i < draws; i++) {
+            sampleDistinctMersenne(popSize, 3, i % popSize, donors);
+            checksum += donors[0];
+        }
+    });
+
+    double xoshiro = measure(3, [&checksum]() {
+        Random random;
+        unsigned int donors[3];
+        for (unsigned int i = 0; i < draws; i++) {
+            random.sampleDistinct(popSize, 3, {i % popSize}, donors);
+            checksum += donors[0];
+        }
+    });
+
+    std::printf("3 of %u donors, target excluded (checksum %lu)\n", popSize, checksum);
+    std::printf("unordered_set, mt19937      %6.1f ns per draw\n", sets / draws * 1e9);
+    std::printf("fixed array, mt19937        %6.1f ns per draw\n", mersenne / draws * 1e9);
+    std::printf("Random::sampleDistinct      %6.1f ns per draw\n", xoshiro / draws * 1e9);
+}
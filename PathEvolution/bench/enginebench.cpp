@@ -0,0 +1,38 @@
+#include "benchmark.h"
+#include "differentialevolver.h"
+#include <cstdio>
+
+namespace {
+    // The runs have no fixed genes, so every genome is one contiguous run.
+    struct Sphere {
+        double operator()(GenomeView genome) const {
+            const double* genes = genome.data();
+            double sum = 0;
+            for (unsigned int i = 0; i < genome.size(); i++) {
+                sum -= genes[i] * genes[i];
+            }
+            return sum;
+        }
+    };
+
+    template <class Evolver>
+    double timeRun(Evolver& evolver)
+    {
+        return measure(5, [&evolver]() {
+            evolver.initialize(50, 30, -5, 5);
+            for (unsigned int i = 0; i < 2000; i++) {
+                evolver.improve();
+            }
+        });
+    }
+}
+
+void runEngineBenchmark()
+{
+    DifferentialEvolver erased(0.9, 0.5);
+    erased.setObjectiveFunction(Sphere());
+    std::printf("type-erased DifferentialEvolver  %.3f s\n", timeRun(erased));
+
+    BasicDifferentialEvolver<Sphere, Strategy<Rand1Mutation, BinomialCrossover>> inlined(0.9, 0.5);
+    std::printf("BasicDifferentialEvolver<Sphere, DE/rand/1/bin>  %.3f s\n", timeRun(inlined));
+}
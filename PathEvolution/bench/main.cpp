@@ -0,0 +1,46 @@
+#include "benchmark.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+double measure(unsigned int repetitions, const std::function<void()>& body)
+{
+    double best = 0;
+    for (unsigned int i = 0; i < repetitions; i++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        body();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (i == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    return best;
+}
+
+// Runs the benchmarks named on the command line, or all of them.
+int main(int argc, char** argv)
+{
+    const std::vector<std::pair<std::string, void (*)()>> benchmarks{
+        {"engine", runEngineBenchmark},
+        {"donors", runDonorBenchmark},
+        {"bezier", runBezierBenchmark}
+    };
+
+    for (const std::pair<std::string, void (*)()>& benchmark : benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) {
+            selected = selected || benchmark.first == argv[i];
+        }
+
+        if (selected) {
+            std::printf("== %s\n", benchmark.first.c_str());
+            benchmark.second();
+        }
+    }
+
+    return 0;
+}
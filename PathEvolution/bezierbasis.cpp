@@ -0,0 +1,97 @@
+#include "bezierbasis.h"
+#include <map>
+#include <mutex>
+#include <utility>
+
+BezierBasis::BezierBasis(unsigned int degree, const std::vector<double>& parameters)
+    : degree(degree), parameters(parameters), weights(parameters.size() * (degree + 1))
+{
+    for (unsigned int sample = 0; sample < parameters.size(); sample++) {
+        evaluate(degree, parameters[sample], &weights[sample * (degree + 1)]);
+    }
+}
+
+std::shared_ptr<const BezierBasis> BezierBasis::uniform(unsigned int degree, unsigned int samples)
+{
+    // Callers keep asking for the same table, so each thread remembers the
+    // last one it got and only takes the lock when that changes.
+    static thread_local std::shared_ptr<const BezierBasis> last;
+    if (last && last->degree == degree && last->getSampleCount() == samples) {
+        return last;
+    }
+
+    static std::mutex mutex;
+    static std::map<std::pair<unsigned int, unsigned int>, std::shared_ptr<const BezierBasis>> tables;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const BezierBasis>& table = tables[std::make_pair(degree, samples)];
+    if (!table) {
+        std::vector<double> parameters(samples);
+        for (unsigned int i = 0; i < samples; i++) {
+            parameters[i] = samples > 1 ? static_cast<double>(i) / (samples - 1) : 0;
+        }
+        table = std::make_shared<const BezierBasis>(degree, parameters);
+    }
+
+    last = table;
+    return table;
+}
+
+void BezierBasis::evaluate(unsigned int degree, double t, double* weights)
+{
+    // weights[i] = C(n, i) t^i (1 - t)^(n - i), with the binomials built up
+    // exactly by the multiplicative formula instead of from factorials.
+    double u = 1 - t;
+    double uPower = 1;
+    for (unsigned int i = degree + 1; i-- > 0;) {
+        weights[i] = uPower;
+        uPower *= u;
+    }
+
+    double binomial = 1;
+    double tPower = 1;
+    for (unsigned int i = 0; i <= degree; i++) {
+        weights[i] *= binomial * tPower;
+        binomial = binomial * (degree - i) / (i + 1);
+        tPower *= t;
+    }
+}
+
+unsigned int BezierBasis::getDegree() const
+{
+    return degree;
+}
+
+unsigned int BezierBasis::getSampleCount() const
+{
+    return parameters.size();
+}
+
+double BezierBasis::getParameter(unsigned int sample) const
+{
+    return parameters[sample];
+}
+
+const double* BezierBasis::row(unsigned int sample) const
+{
+    return &weights[sample * (degree + 1)];
+}
+
+void BezierBasis::sample(GenomeView controls, double* xs, double* ys) const
+{
+    unsigned int width = degree + 1;
+    std::vector<double> points(2 * width);
+    controls.copyTo(points.data());
+
+    for (unsigned int sample = 0; sample < parameters.size(); sample++) {
+        const double* basis = &weights[sample * width];
+        double x = 0;
+        double y = 0;
+        for (unsigned int i = 0; i < width; i++) {
+            x += basis[i] * points[2 * i];
+            y += basis[i] * points[2 * i + 1];
+        }
+        xs[sample] = x;
+        ys[sample] = y;
+    }
+}
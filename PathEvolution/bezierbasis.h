@@ -0,0 +1,38 @@
+#ifndef BEZIERBASIS_H
+#define BEZIERBASIS_H
+
+#include <memory>
+#include <vector>
+#include "population.h"
+
+// Bernstein polynomials of one degree evaluated at a fixed set of curve
+// parameters, stored as a row-major samples x (degree + 1) matrix. Sampling
+// a curve is then a dense product of that matrix with its control points.
+// Tables never change once built, so they are shared freely between threads.
+class BezierBasis
+{
+private:
+    unsigned int degree;
+    std::vector<double> parameters;
+    std::vector<double> weights;
+
+public:
+    BezierBasis(unsigned int degree, const std::vector<double>& parameters);
+
+    // The table for samples parameters evenly spread over [0, 1], ends
+    // included. Built on first use and cached for the rest of the program.
+    static std::shared_ptr<const BezierBasis> uniform(unsigned int degree, unsigned int samples);
+    // Writes the degree + 1 Bernstein polynomials at t to weights.
+    static void evaluate(unsigned int degree, double t, double* weights);
+
+    unsigned int getDegree() const;
+    unsigned int getSampleCount() const;
+    double getParameter(unsigned int sample) const;
+    const double* row(unsigned int sample) const;
+
+    // controls holds degree + 1 points as x, y pairs; the curve points go
+    // to xs and ys, one per sample.
+    void sample(GenomeView controls, double* xs, double* ys) const;
+};
+
+#endif // BEZIERBASIS_H
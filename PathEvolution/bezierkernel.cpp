@@ -0,0 +1,42 @@
+#include "bezierkernel.h"
+
+namespace {
+    struct Kernels {
+        BezierKernelFactory::Evaluator evaluator;
+        BezierKernelFactory::UniformSampler uniformSampler;
+    };
+
+    // Fills table[1..Degree] with the instantiations of those degrees.
+    template <int Degree>
+    struct KernelTable {
+        static void fill(Kernels* table) {
+            table[Degree] = Kernels{&BezierKernel<Degree>::evaluate, &BezierKernel<Degree>::sampleUniform};
+            KernelTable<Degree - 1>::fill(table);
+        }
+    };
+
+    template <>
+    struct KernelTable<0> {
+        static void fill(Kernels* table) {
+            table[0] = Kernels{&BezierKernel<0>::evaluate, &BezierKernel<0>::sampleUniform};
+        }
+    };
+
+    const Kernels* kernels()
+    {
+        static Kernels table[BezierKernelFactory::MaxDegree + 1];
+        static bool filled = (KernelTable<BezierKernelFactory::MaxDegree>::fill(table), true);
+        (void) filled;
+        return table;
+    }
+}
+
+BezierKernelFactory::Evaluator BezierKernelFactory::evaluator(unsigned int degree)
+{
+    return degree <= MaxDegree ? kernels()[degree].evaluator : nullptr;
+}
+
+BezierKernelFactory::UniformSampler BezierKernelFactory::uniformSampler(unsigned int degree)
+{
+    return degree <= MaxUniformDegree ? kernels()[degree].uniformSampler : nullptr;
+}
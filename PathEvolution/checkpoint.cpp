@@ -0,0 +1,190 @@
+#include "checkpoint.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(CheckpointHeader) % sizeof(double) == 0, "sections after the header must stay aligned");
+
+bool CheckpointHeader::isValid() const
+{
+    CheckpointHeader reference;
+    return std::memcmp(magic, reference.magic, sizeof(magic)) == 0 &&
+           version == CurrentVersion && byteOrder == ByteOrderMark;
+}
+
+bool writeCheckpoint(const std::string& path, const CheckpointHeader& header,
+                     const std::vector<CheckpointSection>& sections)
+{
+    // Written next to the target and renamed over it, so a crash never leaves
+    // a half-written checkpoint behind.
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const CheckpointSection& section : sections) {
+        out.write(static_cast<const char*>(section.data), section.bytes);
+    }
+    out.close();
+
+    if (!out) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    return MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+}
+
+std::size_t checkpointSize(std::initializer_list<std::uint64_t> counts)
+{
+    const std::uint64_t limit = std::numeric_limits<std::size_t>::max() / sizeof(double);
+    std::uint64_t total = sizeof(CheckpointHeader) / sizeof(double);
+    for (std::uint64_t count : counts) {
+        if (count > limit - total) {
+            return 0;
+        }
+        total += count;
+    }
+
+    return total * sizeof(double);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    file = handle;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+        close();
+        return false;
+    }
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+
+    mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        return false;
+    }
+
+    bytes = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        close();
+        return false;
+    }
+    length = static_cast<std::size_t>(status.st_size);
+
+    void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    bytes = address == MAP_FAILED ? nullptr : static_cast<const unsigned char*>(address);
+#endif
+
+    if (bytes == nullptr) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (bytes != nullptr) {
+        UnmapViewOfFile(bytes);
+    }
+    if (mapping != nullptr) {
+        CloseHandle(mapping);
+    }
+    if (file != nullptr) {
+        CloseHandle(file);
+    }
+    mapping = nullptr;
+    file = nullptr;
+#else
+    if (bytes != nullptr) {
+        munmap(const_cast<unsigned char*>(bytes), length);
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+    descriptor = -1;
+#endif
+
+    bytes = nullptr;
+    length = 0;
+}
+
+CheckpointReader::CheckpointReader(const MappedFile& file)
+    : file(file)
+{
+
+}
+
+const CheckpointHeader* CheckpointReader::header()
+{
+    if (file.size() < sizeof(CheckpointHeader)) {
+        return nullptr;
+    }
+
+    const CheckpointHeader* header = reinterpret_cast<const CheckpointHeader*>(file.data());
+    if (!header->isValid()) {
+        return nullptr;
+    }
+
+    offset = sizeof(CheckpointHeader);
+    return header;
+}
+
+const double* CheckpointReader::take(std::size_t count)
+{
+    std::size_t bytes = count * sizeof(double);
+    if (offset == 0 || file.size() - offset < bytes) {
+        // Later sections cannot be located either.
+        offset = 0;
+        return nullptr;
+    }
+
+    const double* values = reinterpret_cast<const double*>(file.data() + offset);
+    offset += bytes;
+    return values;
+}
+
+bool CheckpointReader::atEnd() const
+{
+    return offset == file.size();
+}
@@ -0,0 +1,102 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Fixed-size header at the start of a checkpoint file. The arrays follow it
+// back to back, in the order the writer lists them, as raw native-endian
+// doubles, so a mapped file can be used in place without any parsing.
+struct CheckpointHeader {
+    static const std::uint32_t CurrentVersion = 2;
+    static const std::uint32_t ByteOrderMark = 0x01020304;
+
+    char magic[8] = {'P', 'E', 'V', 'O', 'C', 'K', 'P', 'T'};
+    std::uint32_t version = CurrentVersion;
+    std::uint32_t byteOrder = ByteOrderMark;
+
+    std::uint64_t seed = 0;
+    std::uint64_t generation = 0;
+    std::uint64_t evaluations = 0;
+
+    std::uint32_t popSize = 0;
+    std::uint32_t initialPopSize = 0;
+    // Evolved genes per individual; the fixed prefix and suffix are stored
+    // once, as the last two sections.
+    std::uint32_t dimensionality = 0;
+    std::uint32_t stride = 0;
+    std::uint32_t prefixLength = 0;
+    std::uint32_t suffixLength = 0;
+    std::uint32_t parameterMode = 0;
+    std::uint32_t memorySize = 0;
+    std::uint32_t memoryIndex = 0;
+    std::uint32_t archiveSize = 0;
+    std::uint32_t restarts = 0;
+    std::uint32_t reserved = 0;
+
+    double lowerBound = 0;
+    double upperBound = 0;
+
+    bool isValid() const;
+};
+
+struct CheckpointSection {
+    const void* data;
+    std::size_t bytes;
+};
+
+// Writes header followed by every section; returns false on I/O errors.
+bool writeCheckpoint(const std::string& path, const CheckpointHeader& header,
+                     const std::vector<CheckpointSection>& sections);
+
+// Size in bytes of a checkpoint whose sections hold counts doubles each,
+// header included, or 0 if it would not fit in std::size_t.
+std::size_t checkpointSize(std::initializer_list<std::uint64_t> counts);
+
+// Read-only memory mapping of a whole file.
+class MappedFile
+{
+private:
+    const unsigned char* bytes = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#else
+    int descriptor = -1;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+};
+
+// Walks the sections of a mapped checkpoint. Returns nullptr once the file
+// runs out, so truncated files are detected instead of read past.
+class CheckpointReader
+{
+private:
+    const MappedFile& file;
+    std::size_t offset = 0;
+
+public:
+    explicit CheckpointReader(const MappedFile& file);
+
+    // The header, or nullptr if the file is not a checkpoint of this version.
+    const CheckpointHeader* header();
+    const double* take(std::size_t count);
+    bool atEnd() const;
+};
+
+#endif // CHECKPOINT_H
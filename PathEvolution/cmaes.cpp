@@ -0,0 +1,413 @@
+#include "cmaes.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // Cyclic Jacobi eigenvalue algorithm for the symmetric n x n row-major
+    // matrix a, which is destroyed. Eigenvalues end up in values and the
+    // matching eigenvectors in the columns of vectors.
+    void jacobiEigen(std::vector<double>& a, unsigned int n, std::vector<double>& values, std::vector<double>& vectors)
+    {
+        vectors.assign(static_cast<std::size_t>(n) * n, 0.0);
+        for (unsigned int i = 0; i < n; i++) {
+            vectors[i * n + i] = 1;
+        }
+
+        for (int sweep = 0; sweep < 64; sweep++) {
+            double off = 0;
+            double diagonal = 0;
+            for (unsigned int p = 0; p < n; p++) {
+                diagonal += a[p * n + p] * a[p * n + p];
+                for (unsigned int q = p + 1; q < n; q++) {
+                    off += a[p * n + q] * a[p * n + q];
+                }
+            }
+            if (off <= 1e-30 * diagonal) {
+                break;
+            }
+
+            for (unsigned int p = 0; p < n; p++) {
+                for (unsigned int q = p + 1; q < n; q++) {
+                    double apq = a[p * n + q];
+                    if (apq == 0) {
+                        continue;
+                    }
+
+                    double theta = (a[q * n + q] - a[p * n + p]) / (2 * apq);
+                    double t = (theta >= 0 ? 1 : -1) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                    double c = 1 / std::sqrt(t * t + 1);
+                    double s = t * c;
+
+                    for (unsigned int k = 0; k < n; k++) {
+                        double akp = a[k * n + p];
+                        double akq = a[k * n + q];
+                        a[k * n + p] = c * akp - s * akq;
+                        a[k * n + q] = s * akp + c * akq;
+                    }
+                    for (unsigned int k = 0; k < n; k++) {
+                        double apk = a[p * n + k];
+                        double aqk = a[q * n + k];
+                        a[p * n + k] = c * apk - s * aqk;
+                        a[q * n + k] = s * apk + c * aqk;
+                    }
+                    for (unsigned int k = 0; k < n; k++) {
+                        double vkp = vectors[k * n + p];
+                        double vkq = vectors[k * n + q];
+                        vectors[k * n + p] = c * vkp - s * vkq;
+                        vectors[k * n + q] = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+
+        values.resize(n);
+        for (unsigned int i = 0; i < n; i++) {
+            values[i] = a[i * n + i];
+        }
+    }
+}
+
+CMAES::CMAES(double initialStepSize)
+    : initialStepSize(initialStepSize)
+{
+
+}
+
+void CMAES::initialize(unsigned int popSize, unsigned int dimensionality, double min, double max,
+                       const Individual& prefix, const Individual& suffix)
+{
+    unsigned int n = dimensionality - prefix.size() - suffix.size();
+    this->dimensionality = n;
+    lowerBound = min;
+    upperBound = max;
+
+    lambda = popSize > 0 ? popSize : 4 + static_cast<unsigned int>(3 * std::log(static_cast<double>(n)));
+    lambda = std::max(2u, lambda);
+    mu = lambda / 2;
+
+    weights.resize(mu);
+    double sum = 0;
+    for (unsigned int i = 0; i < mu; i++) {
+        weights[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+        sum += weights[i];
+    }
+    double squares = 0;
+    for (double& weight : weights) {
+        weight /= sum;
+        squares += weight * weight;
+    }
+    mueff = 1 / squares;
+
+    cc = (4 + mueff / n) / (n + 4 + 2 * mueff / n);
+    cs = (mueff + 2) / (n + mueff + 5);
+    c1 = 2 / ((n + 1.3) * (n + 1.3) + mueff);
+    cmu = std::min(1 - c1, 2 * (mueff - 2 + 1 / mueff) / ((n + 2.0) * (n + 2.0) + mueff));
+    damps = 1 + 2 * std::max(0.0, std::sqrt((mueff - 1) / (n + 1)) - 1) + cs;
+    chiN = std::sqrt(static_cast<double>(n)) * (1 - 1.0 / (4 * n) + 1.0 / (21.0 * n * n));
+
+    sigma = initialStepSize * (max - min);
+    mean.resize(n);
+    Random random = Random::stream(seed, InitializationStream);
+    random.fillUniform(mean.data(), n, min, max);
+
+    evolutionPath.assign(n, 0.0);
+    conjugatePath.assign(n, 0.0);
+    covariance.assign(static_cast<std::size_t>(n) * n, 0.0);
+    for (unsigned int i = 0; i < n; i++) {
+        covariance[i * n + i] = 1;
+    }
+    decompose();
+
+    steps.assign(static_cast<std::size_t>(lambda) * n, 0.0);
+    order.resize(lambda);
+    population.resize(lambda, n);
+    population.setFixedGenes(prefix, suffix);
+
+    bestGenes = mean;
+    bestFitness = std::numeric_limits<double>::max() * -1;
+    statistics = GenerationStatistics();
+    startTime = std::chrono::steady_clock::now();
+    convergenceMonitor.reset();
+    terminationReason = TerminationReason::None;
+    generation = 0;
+    evaluations = 0;
+}
+
+void CMAES::setSeed(std::uint64_t seed)
+{
+    this->seed = seed;
+}
+
+void CMAES::setObjectiveFunction(ObjectiveFunction function)
+{
+    objective = [function](GenomeMatrixView trials, double* fitnesses) {
+        for (unsigned int i = 0; i < trials.rows(); i++) {
+            fitnesses[i] = function(trials.row(i));
+        }
+    };
+}
+
+void CMAES::setBatchObjectiveFunction(BatchObjectiveFunction function)
+{
+    objective = function;
+}
+
+void CMAES::setParallelEvaluation(bool enabled, unsigned int threadCount)
+{
+    if (enabled) {
+        pool.reset(new ThreadPool(threadCount));
+    } else {
+        pool.reset();
+    }
+}
+
+void CMAES::improve()
+{
+    if (isFinished()) {
+        return;
+    }
+
+    sample();
+    evaluate();
+    update();
+}
+
+void CMAES::sample()
+{
+    unsigned int n = dimensionality;
+    std::vector<double> z(n);
+
+    for (unsigned int k = 0; k < lambda; k++) {
+        Random random = Random::stream(seed, SamplingStream, generation, k);
+        for (unsigned int j = 0; j < n; j++) {
+            z[j] = random.normal(0, 1);
+        }
+
+        double* y = steps.data() + static_cast<std::size_t>(k) * n;
+        double* x = population.trial(k);
+        for (unsigned int i = 0; i < n; i++) {
+            const double* row = transform.data() + static_cast<std::size_t>(i) * n;
+            double value = 0;
+            for (unsigned int j = 0; j < n; j++) {
+                value += row[j] * z[j];
+            }
+            x[i] = std::max(lowerBound, std::min(upperBound, mean[i] + sigma * value));
+            // The update learns from the clamped step, otherwise the mean would
+            // drift past a bound along which the fitness no longer changes.
+            y[i] = (x[i] - mean[i]) / sigma;
+        }
+    }
+}
+
+void CMAES::evaluate()
+{
+    if (pool) {
+        unsigned int blocks = std::min(lambda, pool->getThreadCount() * 2);
+        pool->parallelFor(blocks, [this, blocks](unsigned int block) {
+            unsigned int first = block * lambda / blocks;
+            unsigned int last = (block + 1) * lambda / blocks;
+            objective(population.trialMatrix(first, last - first), &population.trialFitness(first));
+        });
+    } else {
+        objective(population.trialMatrix(0, lambda), &population.trialFitness(0));
+    }
+    evaluations += lambda;
+
+    unsigned int improvements = 0;
+    for (unsigned int k = 0; k < lambda; k++) {
+        population.acceptTrial(k);
+        if (population.fitness(k) > bestFitness) {
+            bestFitness = population.fitness(k);
+            bestGenes.assign(population.genome(k), population.genome(k) + dimensionality);
+            improvements++;
+        }
+    }
+    statistics.improvements = improvements;
+}
+
+void CMAES::update()
+{
+    unsigned int n = dimensionality;
+
+    for (unsigned int k = 0; k < lambda; k++) {
+        order[k] = k;
+    }
+    std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+        return population.fitness(a) > population.fitness(b);
+    });
+
+    // Weighted mean step of the mu best.
+    std::vector<double> meanStep(n, 0.0);
+    for (unsigned int i = 0; i < mu; i++) {
+        const double* y = steps.data() + static_cast<std::size_t>(order[i]) * n;
+        for (unsigned int j = 0; j < n; j++) {
+            meanStep[j] += weights[i] * y[j];
+        }
+    }
+    for (unsigned int j = 0; j < n; j++) {
+        mean[j] += sigma * meanStep[j];
+    }
+
+    // C^(-1/2) * meanStep = B * D^-1 * B^T * meanStep.
+    std::vector<double> rotated(n, 0.0);
+    for (unsigned int i = 0; i < n; i++) {
+        for (unsigned int j = 0; j < n; j++) {
+            rotated[j] += eigenvectors[i * n + j] * meanStep[i];
+        }
+    }
+    for (unsigned int j = 0; j < n; j++) {
+        rotated[j] /= deviations[j];
+    }
+
+    double conjugateFactor = std::sqrt(cs * (2 - cs) * mueff);
+    double conjugateNorm = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        const double* row = eigenvectors.data() + static_cast<std::size_t>(i) * n;
+        double whitened = 0;
+        for (unsigned int j = 0; j < n; j++) {
+            whitened += row[j] * rotated[j];
+        }
+        conjugatePath[i] = (1 - cs) * conjugatePath[i] + conjugateFactor * whitened;
+        conjugateNorm += conjugatePath[i] * conjugatePath[i];
+    }
+    conjugateNorm = std::sqrt(conjugateNorm);
+
+    double correction = std::sqrt(1 - std::pow(1 - cs, 2.0 * (generation + 1)));
+    bool stalled = conjugateNorm / correction / chiN >= 1.4 + 2.0 / (n + 1);
+    double evolutionFactor = stalled ? 0 : std::sqrt(cc * (2 - cc) * mueff);
+    for (unsigned int j = 0; j < n; j++) {
+        evolutionPath[j] = (1 - cc) * evolutionPath[j] + evolutionFactor * meanStep[j];
+    }
+
+    // Rank-one and rank-mu update of the upper triangle, each row a
+    // contiguous sweep; the lower triangle is mirrored afterwards.
+    double decay = 1 - c1 - cmu + (stalled ? c1 * cc * (2 - cc) : 0);
+    for (unsigned int i = 0; i < n; i++) {
+        double* row = covariance.data() + static_cast<std::size_t>(i) * n;
+        double rankOne = c1 * evolutionPath[i];
+        for (unsigned int j = i; j < n; j++) {
+            row[j] = decay * row[j] + rankOne * evolutionPath[j];
+        }
+    }
+    for (unsigned int k = 0; k < mu; k++) {
+        const double* y = steps.data() + static_cast<std::size_t>(order[k]) * n;
+        double weight = cmu * weights[k];
+        for (unsigned int i = 0; i < n; i++) {
+            double* row = covariance.data() + static_cast<std::size_t>(i) * n;
+            double scaled = weight * y[i];
+            for (unsigned int j = i; j < n; j++) {
+                row[j] += scaled * y[j];
+            }
+        }
+    }
+    for (unsigned int i = 0; i < n; i++) {
+        for (unsigned int j = 0; j < i; j++) {
+            covariance[i * n + j] = covariance[j * n + i];
+        }
+    }
+
+    sigma *= std::exp((cs / damps) * (conjugateNorm / chiN - 1));
+    generation++;
+
+    if (generation - decomposedGeneration > lambda / (c1 + cmu) / n / 10) {
+        decompose();
+    }
+
+    statistics.generation = generation;
+    statistics.evaluations = evaluations;
+    statistics.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    statistics.measure(population, 0, n, bestFitness);
+
+    terminationReason = convergenceMonitor.update(statistics);
+    double largest = *std::max_element(deviations.begin(), deviations.end());
+    if (terminationReason == TerminationReason::None && sigma * largest < 1e-12 * (upperBound - lowerBound)) {
+        terminationReason = TerminationReason::Stagnation;
+    }
+
+    if (statisticsCallback) {
+        statisticsCallback(statistics);
+    }
+}
+
+void CMAES::decompose()
+{
+    unsigned int n = dimensionality;
+    std::vector<double> matrix = covariance;
+    std::vector<double> values;
+    jacobiEigen(matrix, n, values, eigenvectors);
+
+    deviations.resize(n);
+    for (unsigned int j = 0; j < n; j++) {
+        deviations[j] = std::sqrt(std::max(values[j], 1e-300));
+    }
+
+    transform.resize(static_cast<std::size_t>(n) * n);
+    for (unsigned int i = 0; i < n; i++) {
+        for (unsigned int j = 0; j < n; j++) {
+            transform[i * n + j] = eigenvectors[i * n + j] * deviations[j];
+        }
+    }
+
+    decomposedGeneration = generation;
+}
+
+bool CMAES::isFinished() const
+{
+    return terminationReason != TerminationReason::None;
+}
+
+void CMAES::setTermination(const TerminationCriteria& criteria)
+{
+    convergenceMonitor = ConvergenceMonitor(criteria);
+}
+
+TerminationReason CMAES::getTerminationReason() const
+{
+    return terminationReason;
+}
+
+PopulationView CMAES::getPopulation() const
+{
+    return PopulationView(population);
+}
+
+GenomeView CMAES::getBestIndividual() const
+{
+    return GenomeView(population.getPrefix(), bestGenes.data(), dimensionality, population.getSuffix());
+}
+
+double CMAES::getBestFitness() const
+{
+    return bestFitness;
+}
+
+double CMAES::getFitness(unsigned int index) const
+{
+    return population.fitness(index);
+}
+
+unsigned long CMAES::getGeneration() const
+{
+    return generation;
+}
+
+unsigned long CMAES::getEvaluations() const
+{
+    return evaluations;
+}
+
+double CMAES::getStepSize() const
+{
+    return sigma;
+}
+
+void CMAES::setStatisticsCallback(StatisticsCallback callback)
+{
+    statisticsCallback = callback;
+}
+
+const GenerationStatistics& CMAES::getStatistics() const
+{
+    return statistics;
+}
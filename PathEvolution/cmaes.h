@@ -0,0 +1,118 @@
+#ifndef CMAES_H
+#define CMAES_H
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include "optimizer.h"
+#include "population.h"
+#include "threadpool.h"
+#include "termination.h"
+#include "random.h"
+
+// Covariance matrix adaptation evolution strategy, (mu/mu_w, lambda) with
+// cumulative step-size adaptation and rank-one plus rank-mu covariance updates
+// (Hansen, "The CMA Evolution Strategy: A Tutorial", 2016).
+//
+// A generation samples all lambda offspring as one matrix product of standard
+// normal rows with B*D, evaluates them as one batch and updates C from the
+// mu best, accumulating only its upper triangle row by row. The eigensystem of
+// C is recomputed with Jacobi rotations every few generations, as the
+// tutorial suggests, since that is O(n^3).
+class CMAES : public Optimizer
+{
+public:
+    // initialStepSize is relative to the width of the initialization range.
+    explicit CMAES(double initialStepSize = 0.3);
+
+    // popSize is lambda; 0 picks the default 4 + 3 ln(n). The mean starts at
+    // a uniform random point of [min, max]. Samples are clamped to that range
+    // before evaluation.
+    void initialize(unsigned int popSize, unsigned int dimensionality, double min, double max,
+                    const Individual& prefix = Individual(), const Individual& suffix = Individual()) override;
+    // Takes effect at the next initialize().
+    void setSeed(std::uint64_t seed) override;
+    void setObjectiveFunction(ObjectiveFunction function) override;
+    void setBatchObjectiveFunction(BatchObjectiveFunction function) override;
+    void setParallelEvaluation(bool enabled, unsigned int threadCount = 0) override;
+
+    void improve() override;
+    // Finished once a termination criterion is met or the step size has
+    // shrunk to nothing.
+    bool isFinished() const override;
+    void setTermination(const TerminationCriteria& criteria) override;
+    TerminationReason getTerminationReason() const override;
+
+    // The offspring of the last generation.
+    PopulationView getPopulation() const override;
+    GenomeView getBestIndividual() const override;
+    double getBestFitness() const override;
+    double getFitness(unsigned int index) const override;
+    unsigned long getGeneration() const override;
+    unsigned long getEvaluations() const override;
+    double getStepSize() const;
+
+    void setStatisticsCallback(StatisticsCallback callback) override;
+    const GenerationStatistics& getStatistics() const override;
+
+private:
+    enum Stream : std::uint64_t {
+        InitializationStream,
+        SamplingStream
+    };
+
+    double initialStepSize;
+    unsigned int dimensionality = 0;
+    unsigned int lambda = 0;
+    unsigned int mu = 0;
+    double lowerBound = 0;
+    double upperBound = 0;
+
+    std::vector<double> weights;
+    double mueff = 0;
+    double cc = 0;
+    double cs = 0;
+    double c1 = 0;
+    double cmu = 0;
+    double damps = 0;
+    double chiN = 0;
+
+    double sigma = 0;
+    std::vector<double> mean;
+    std::vector<double> evolutionPath;
+    std::vector<double> conjugatePath;
+    // n x n, row-major. C is symmetric; B holds eigenvectors as columns and
+    // BD = B * diag(D), where D are the square roots of the eigenvalues.
+    std::vector<double> covariance;
+    std::vector<double> eigenvectors;
+    std::vector<double> deviations;
+    std::vector<double> transform;
+    unsigned long decomposedGeneration = 0;
+
+    // Offspring steps y = BD * z, one row per offspring.
+    std::vector<double> steps;
+    std::vector<unsigned int> order;
+    Population population;
+
+    BatchObjectiveFunction objective;
+    std::unique_ptr<ThreadPool> pool;
+
+    std::vector<double> bestGenes;
+    double bestFitness = 0;
+    GenerationStatistics statistics;
+    StatisticsCallback statisticsCallback;
+    std::chrono::steady_clock::time_point startTime;
+    ConvergenceMonitor convergenceMonitor;
+    TerminationReason terminationReason = TerminationReason::None;
+
+    std::uint64_t seed = Random::DefaultSeed;
+    unsigned long generation = 0;
+    unsigned long evaluations = 0;
+
+    void sample();
+    void evaluate();
+    void update();
+    void decompose();
+};
+
+#endif // CMAES_H
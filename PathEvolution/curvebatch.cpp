@@ -0,0 +1,213 @@
+#include "curvebatch.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CURVEBATCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    const unsigned int registerWidth = 8;
+
+    // out (rows x columns) = weights (rows x depth) * controls (depth x columns).
+    void multiplyScalar(const double* weights, unsigned int rows, unsigned int depth,
+                        const double* controls, unsigned int columns, double* out)
+    {
+        for (unsigned int row = 0; row < rows; row++) {
+            const double* basis = weights + row * depth;
+            double* result = out + row * columns;
+            for (unsigned int column = 0; column < columns; column++) {
+                result[column] = 0;
+            }
+            for (unsigned int k = 0; k < depth; k++) {
+                const double* control = controls + k * columns;
+                for (unsigned int column = 0; column < columns; column++) {
+                    result[column] += basis[k] * control[column];
+                }
+            }
+        }
+    }
+
+#ifdef CURVEBATCH_X86
+    // Both kernels keep four accumulator registers of one output row in
+    // flight over the whole depth and expect columns to be a multiple of registerWidth.
+
+    __attribute__((target("avx2,fma")))
+    void multiplyAVX2(const double* weights, unsigned int rows, unsigned int depth,
+                      const double* controls, unsigned int columns, double* out)
+    {
+        for (unsigned int row = 0; row < rows; row++) {
+            const double* basis = weights + row * depth;
+            double* result = out + row * columns;
+
+            unsigned int column = 0;
+            for (; column + 16 <= columns; column += 16) {
+                __m256d sum0 = _mm256_setzero_pd();
+                __m256d sum1 = _mm256_setzero_pd();
+                __m256d sum2 = _mm256_setzero_pd();
+                __m256d sum3 = _mm256_setzero_pd();
+                for (unsigned int k = 0; k < depth; k++) {
+                    __m256d weight = _mm256_broadcast_sd(basis + k);
+                    const double* control = controls + k * columns + column;
+                    sum0 = _mm256_fmadd_pd(weight, _mm256_loadu_pd(control), sum0);
+                    sum1 = _mm256_fmadd_pd(weight, _mm256_loadu_pd(control + 4), sum1);
+                    sum2 = _mm256_fmadd_pd(weight, _mm256_loadu_pd(control + 8), sum2);
+                    sum3 = _mm256_fmadd_pd(weight, _mm256_loadu_pd(control + 12), sum3);
+                }
+                _mm256_storeu_pd(result + column, sum0);
+                _mm256_storeu_pd(result + column + 4, sum1);
+                _mm256_storeu_pd(result + column + 8, sum2);
+                _mm256_storeu_pd(result + column + 12, sum3);
+            }
+            for (; column < columns; column += 4) {
+                __m256d sum = _mm256_setzero_pd();
+                for (unsigned int k = 0; k < depth; k++) {
+                    sum = _mm256_fmadd_pd(_mm256_broadcast_sd(basis + k), _mm256_loadu_pd(controls + k * columns + column), sum);
+                }
+                _mm256_storeu_pd(result + column, sum);
+            }
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void multiplyAVX512(const double* weights, unsigned int rows, unsigned int depth,
+                        const double* controls, unsigned int columns, double* out)
+    {
+        for (unsigned int row = 0; row < rows; row++) {
+            const double* basis = weights + row * depth;
+            double* result = out + row * columns;
+
+            unsigned int column = 0;
+            for (; column + 32 <= columns; column += 32) {
+                __m512d sum0 = _mm512_setzero_pd();
+                __m512d sum1 = _mm512_setzero_pd();
+                __m512d sum2 = _mm512_setzero_pd();
+                __m512d sum3 = _mm512_setzero_pd();
+                for (unsigned int k = 0; k < depth; k++) {
+                    __m512d weight = _mm512_set1_pd(basis[k]);
+                    const double* control = controls + k * columns + column;
+                    sum0 = _mm512_fmadd_pd(weight, _mm512_loadu_pd(control), sum0);
+                    sum1 = _mm512_fmadd_pd(weight, _mm512_loadu_pd(control + 8), sum1);
+                    sum2 = _mm512_fmadd_pd(weight, _mm512_loadu_pd(control + 16), sum2);
+                    sum3 = _mm512_fmadd_pd(weight, _mm512_loadu_pd(control + 24), sum3);
+                }
+                _mm512_storeu_pd(result + column, sum0);
+                _mm512_storeu_pd(result + column + 8, sum1);
+                _mm512_storeu_pd(result + column + 16, sum2);
+                _mm512_storeu_pd(result + column + 24, sum3);
+            }
+            for (; column < columns; column += 8) {
+                __m512d sum = _mm512_setzero_pd();
+                for (unsigned int k = 0; k < depth; k++) {
+                    sum = _mm512_fmadd_pd(_mm512_set1_pd(basis[k]), _mm512_loadu_pd(controls + k * columns + column), sum);
+                }
+                _mm512_storeu_pd(result + column, sum);
+            }
+        }
+    }
+#endif
+}
+
+CurveBatch::CurveBatch() : instructionSet(detectInstructionSet())
+{
+
+}
+
+CurveBatch::InstructionSet CurveBatch::detectInstructionSet()
+{
+#ifdef CURVEBATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return InstructionSet::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return InstructionSet::AVX2;
+    }
+#endif
+    return InstructionSet::Scalar;
+}
+
+const char* CurveBatch::toString(CurveBatch::InstructionSet set)
+{
+    switch (set) {
+    case InstructionSet::AVX512:
+        return "AVX-512";
+    case InstructionSet::AVX2:
+        return "AVX2";
+    default:
+        return "scalar";
+    }
+}
+
+void CurveBatch::setInstructionSet(CurveBatch::InstructionSet set)
+{
+    instructionSet = std::min(set, detectInstructionSet());
+}
+
+CurveBatch::InstructionSet CurveBatch::getInstructionSet() const
+{
+    return instructionSet;
+}
+
+void CurveBatch::sample(const BezierBasis& basis, GenomeMatrixView genomes)
+{
+    unsigned int depth = basis.getDegree() + 1;
+    curveCount = genomes.rows();
+    sampleCount = basis.getSampleCount();
+    paddedCount = (curveCount + registerWidth - 1) / registerWidth * registerWidth;
+    unsigned int columns = 2 * paddedCount;
+
+    // Padding columns stay zero and give zero points nobody reads.
+    controls.assign(depth * columns, 0);
+    genome.resize(2 * depth);
+    for (unsigned int curve = 0; curve < curveCount; curve++) {
+        genomes.row(curve).copyTo(genome.data());
+        for (unsigned int k = 0; k < depth; k++) {
+            controls[k * columns + curve] = genome[2 * k];
+            controls[k * columns + paddedCount + curve] = genome[2 * k + 1];
+        }
+    }
+
+    points.resize(sampleCount * columns);
+    if (columns == 0 || sampleCount == 0) {
+        return;
+    }
+
+    const double* weights = basis.row(0);
+#ifdef CURVEBATCH_X86
+    if (instructionSet == InstructionSet::AVX512) {
+        multiplyAVX512(weights, sampleCount, depth, controls.data(), columns, points.data());
+        return;
+    }
+    if (instructionSet == InstructionSet::AVX2) {
+        multiplyAVX2(weights, sampleCount, depth, controls.data(), columns, points.data());
+        return;
+    }
+#endif
+    multiplyScalar(weights, sampleCount, depth, controls.data(), columns, points.data());
+}
+
+unsigned int CurveBatch::size() const
+{
+    return curveCount;
+}
+
+unsigned int CurveBatch::getSampleCount() const
+{
+    return sampleCount;
+}
+
+unsigned int CurveBatch::stride() const
+{
+    return 2 * paddedCount;
+}
+
+const double* CurveBatch::x(unsigned int sample) const
+{
+    return points.data() + sample * 2 * paddedCount;
+}
+
+const double* CurveBatch::y(unsigned int sample) const
+{
+    return points.data() + sample * 2 * paddedCount + paddedCount;
+}
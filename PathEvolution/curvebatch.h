@@ -0,0 +1,56 @@
+#ifndef CURVEBATCH_H
+#define CURVEBATCH_H
+
+#include <vector>
+#include "bezierbasis.h"
+#include "population.h"
+
+// Samples the Bezier curves of a whole batch of genomes at once, as one
+// matrix product: the basis table (samples x points) times the control
+// points of every curve (points x 2 * curves, all x columns then all y
+// columns). The result comes out structure-of-arrays, one row of x and one
+// of y per sample, each holding that sample of every curve, so that terms
+// summed along the curves can be vectorized across the batch.
+//
+// The product runs on AVX-512 or AVX2 with FMA when the processor has them,
+// and on plain loops otherwise.
+class CurveBatch
+{
+public:
+    enum class InstructionSet { Scalar, AVX2, AVX512 };
+
+private:
+    unsigned int curveCount = 0;
+    unsigned int sampleCount = 0;
+    // Columns of each half, rounded up to whole AVX-512 registers.
+    unsigned int paddedCount = 0;
+    // One whole genome at a time, while the controls are transposed.
+    std::vector<double> genome;
+    std::vector<double> controls;
+    std::vector<double> points;
+    InstructionSet instructionSet;
+
+public:
+    CurveBatch();
+
+    // The best set this processor supports.
+    static InstructionSet detectInstructionSet();
+    static const char* toString(InstructionSet set);
+    // Falls back to the best supported set if set is not available.
+    void setInstructionSet(InstructionSet set);
+    InstructionSet getInstructionSet() const;
+
+    // Every row of genomes is a curve of basis.getDegree() + 1 points given
+    // as x, y pairs.
+    void sample(const BezierBasis& basis, GenomeMatrixView genomes);
+
+    unsigned int size() const;
+    unsigned int getSampleCount() const;
+    // Distance between consecutive sample rows of x() and y().
+    unsigned int stride() const;
+    // Sample sample of every curve, indexed by curve.
+    const double* x(unsigned int sample) const;
+    const double* y(unsigned int sample) const;
+};
+
+#endif // CURVEBATCH_H
@@ -1,84 +1,57 @@
 #include "differentialevolver.h"
-#include "util.h"
-#include <unordered_set>
-#include <algorithm>
-#include <limits>
-#include <iostream>
 
-DifferentialEvolver::DifferentialEvolver(double crossoverRate, double scalingFactor)
-    : crossoverRate(crossoverRate), scalingFactor(scalingFactor)
+template class BasicDifferentialEvolver<DynamicObjective, DynamicStrategy>;
+
+DynamicObjective::DynamicObjective(ObjectiveFunction function) : function(function)
 {
 
 }
 
-void DifferentialEvolver::initialize(unsigned int popSize, unsigned int dimensionality,
-                                     double min, double max, const Individual& prefix, const Individual& suffix)
+DynamicObjective DynamicObjective::fromBatch(BatchObjectiveFunction function)
 {
-    this->dimensionality = dimensionality;
-    this->prefixLength = prefix.size();
-    this->suffixLength = suffix.size();
-    for (unsigned int i = 0; i < popSize; i++) {
-        Individual ind = prefix;
-
-        for (unsigned int j = prefixLength; j < dimensionality - suffixLength; j++) {
-            ind.push_back(Util::random(min, max));
-        }
+    DynamicObjective objective;
+    objective.batch = function;
+    return objective;
+}
 
-        ind.insert(ind.end(), suffix.begin(), suffix.end());
+void DynamicObjective::evaluate(GenomeMatrixView trials, double* fitnesses) const
+{
+    if (batch) {
+        batch(trials, fitnesses);
+        return;
+    }
 
-        population.push_back(ind);
-        fitnesses.push_back(std::numeric_limits<double>::max() * -1);
+    for (unsigned int i = 0; i < trials.rows(); i++) {
+        fitnesses[i] = function(trials.row(i));
     }
 }
 
-void DifferentialEvolver::setObjectiveFunction(DifferentialEvolver::ObjectiveFunction function)
+DynamicStrategy::DynamicStrategy()
 {
-    this->objectiveFunction = function;
+    select("DE/rand/1/bin");
 }
 
-void DifferentialEvolver::improve()
+bool DynamicStrategy::select(const std::string& name)
 {
-    for (unsigned int i = 0; i < population.size(); i++) {
-        std::unordered_set<unsigned> agentSet = Util::chooseRandomlyRestricted(population.size(), 3, {i});
-        std::vector<unsigned> agents(agentSet.begin(), agentSet.end());
-
-        const Individual& a = population[agents[0]];
-        const Individual& b = population[agents[1]];
-        const Individual& c = population[agents[2]];
-        Individual candidate = population[i];
-
-        unsigned int R = Util::irandom(prefixLength, dimensionality - 1 - suffixLength);
-
-        for (unsigned int k = prefixLength; k < dimensionality - suffixLength; k++) {
-            double r = Util::random();
-            if (r < crossoverRate || k == R) {
-                candidate[k] = a[k] + scalingFactor * (b[k] - c[k]);
-            }
-        }
-
-        double candidateQuality = objectiveFunction(candidate);
-
-        if (candidateQuality > fitnesses[i]) {
-            population[i] = candidate;
-            fitnesses[i] = candidateQuality;
-        }
+    TrialGenerator generator = StrategyFactory::create(name);
+    if (generator == nullptr) {
+        return false;
     }
-}
 
-const std::vector<DifferentialEvolver::Individual>& DifferentialEvolver::getPopulation() const
-{
-    return population;
+    strategyName = name;
+    this->generator = generator;
+    minimum = StrategyFactory::minimumPopSize(name);
+    return true;
 }
 
-const DifferentialEvolver::Individual& DifferentialEvolver::getBestIndividual() const
+const std::string& DynamicStrategy::name() const
 {
-    auto it = std::max_element(fitnesses.begin(), fitnesses.end());
-    unsigned int index = std::distance(fitnesses.begin(), it);
-
-    return population[index];
+    return strategyName;
 }
 
-double DifferentialEvolver::getFitness(unsigned int index) const
+void adaptStrategy(DynamicStrategy& strategy, ParameterControl::Mode mode)
 {
-    return fitnesses[index];
+    if (mode == ParameterControl::Mode::SHADE || mode == ParameterControl::Mode::LSHADE) {
+        strategy.select("DE/current-to-pbest/1/bin");
+    }
 }
@@ -1,35 +1,99 @@
 #ifndef DIFFERENTIALEVOLVER_H
 #define DIFFERENTIALEVOLVER_H
 
-#include <vector>
-#include <functional>
-#include <utility>
+#include <string>
+#include "basicdifferentialevolver.h"
 
-class DifferentialEvolver
+// Objective held behind std::function, either per individual or per batch.
+class DynamicObjective
 {
+private:
+    // Only one of the two is set. A per-genome function is called directly
+    // rather than through a batch wrapper, so each genome costs one
+    // indirect call.
+    ObjectiveFunction function;
+    BatchObjectiveFunction batch;
+
 public:
-    using Individual = std::vector<double>;
-    using ObjectiveFunction = std::function<double(const Individual&)>;
+    DynamicObjective() = default;
+    DynamicObjective(ObjectiveFunction function);
+
+    static DynamicObjective fromBatch(BatchObjectiveFunction function);
 
-    DifferentialEvolver(double crossoverRate, double scalingFactor);
+    void evaluate(GenomeMatrixView trials, double* fitnesses) const;
+};
 
-    void initialize(unsigned int popSize, unsigned int dimensionality,
-                    double min, double max, const Individual &prefix = Individual(), const Individual& suffix = Individual());
-    void setObjectiveFunction(ObjectiveFunction function);
-    void improve();
+inline void evaluateTrials(const DynamicObjective& objective, GenomeMatrixView trials, double* fitnesses)
+{
+    objective.evaluate(trials, fitnesses);
+}
 
-    const std::vector<Individual>& getPopulation() const;
-    const DifferentialEvolver::Individual &getBestIndividual() const;
-    double getFitness(unsigned int index) const;
+// Strategy chosen at run time through StrategyFactory.
+class DynamicStrategy
+{
 private:
-    unsigned int dimensionality;
-    unsigned int prefixLength;
-    unsigned int suffixLength;
-    double crossoverRate;
-    double scalingFactor;
-    std::vector<Individual> population;
-    std::vector<double> fitnesses;
-    ObjectiveFunction objectiveFunction;
+    std::string strategyName;
+    TrialGenerator generator = nullptr;
+    unsigned int minimum = 0;
+
+public:
+    DynamicStrategy();
+
+    bool select(const std::string& name);
+    const std::string& name() const;
+    unsigned int minimumPopSize() const { return minimum; }
+
+    void buildTrial(const TrialContext& context, unsigned int target, Random& random) const {
+        generator(context, target, random);
+    }
+};
+
+void adaptStrategy(DynamicStrategy& strategy, ParameterControl::Mode mode);
+
+extern template class BasicDifferentialEvolver<DynamicObjective, DynamicStrategy>;
+
+// The run-time configurable evolver, usable through the Optimizer interface.
+class DifferentialEvolver : public BasicDifferentialEvolver<DynamicObjective, DynamicStrategy>, public Optimizer
+{
+private:
+    using Base = BasicDifferentialEvolver<DynamicObjective, DynamicStrategy>;
+
+public:
+    using Individual = Optimizer::Individual;
+    using StatisticsCallback = Optimizer::StatisticsCallback;
+    using ObjectiveFunction = ::ObjectiveFunction;
+    using BatchObjectiveFunction = ::BatchObjectiveFunction;
+
+    DifferentialEvolver(double crossoverRate, double scalingFactor) : Base(crossoverRate, scalingFactor) {}
+
+    void initialize(unsigned int popSize, unsigned int dimensionality, double min, double max,
+                    const Individual& prefix = Individual(), const Individual& suffix = Individual()) override {
+        Base::initialize(popSize, dimensionality, min, max, prefix, suffix);
+    }
+    void setSeed(std::uint64_t seed) override { Base::setSeed(seed); }
+    void setObjectiveFunction(ObjectiveFunction function) override { Base::setObjectiveFunction(function); }
+    void setBatchObjectiveFunction(BatchObjectiveFunction function) override { Base::setBatchObjectiveFunction(function); }
+    void setParallelEvaluation(bool enabled, unsigned int threadCount = 0) override {
+        Base::setParallelEvaluation(enabled, threadCount);
+    }
+
+    void improve() override { Base::improve(); }
+    bool isFinished() const override { return Base::isFinished(); }
+    void setTermination(const TerminationCriteria& criteria) override { Base::setTermination(criteria); }
+    void setTermination(const TerminationCriteria& criteria, TerminationAction action) {
+        Base::setTermination(criteria, action);
+    }
+    TerminationReason getTerminationReason() const override { return Base::getTerminationReason(); }
+
+    PopulationView getPopulation() const override { return Base::getPopulation(); }
+    GenomeView getBestIndividual() const override { return Base::getBestIndividual(); }
+    double getBestFitness() const override { return Base::getBestFitness(); }
+    double getFitness(unsigned int index) const override { return Base::getFitness(index); }
+    unsigned long getGeneration() const override { return Base::getGeneration(); }
+    unsigned long getEvaluations() const override { return Base::getEvaluations(); }
+
+    void setStatisticsCallback(StatisticsCallback callback) override { Base::setStatisticsCallback(callback); }
+    const GenerationStatistics& getStatistics() const override { return Base::getStatistics(); }
 };
 
 #endif // DIFFERENTIALEVOLVER_H
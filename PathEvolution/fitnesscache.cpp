@@ -0,0 +1,143 @@
+#include "fitnesscache.h"
+#include <cmath>
+#include <cstring>
+
+FitnessCache::FitnessCache(std::size_t capacity, double resolution)
+    : capacity(capacity), resolution(resolution)
+{
+    index.reserve(capacity);
+}
+
+bool FitnessCache::lookup(GenomeView genome, double& fitness)
+{
+    std::uint64_t code = hash(genome);
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto found = index.find(code);
+    if (found == index.end() || !matches(*found->second, genome)) {
+        misses++;
+        return false;
+    }
+
+    entries.splice(entries.begin(), entries, found->second);
+    fitness = found->second->fitness;
+    hits++;
+    return true;
+}
+
+void FitnessCache::insert(GenomeView genome, double fitness)
+{
+    if (capacity == 0) {
+        return;
+    }
+
+    std::uint64_t code = hash(genome);
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // A colliding genome simply takes over the slot of the old one.
+    auto found = index.find(code);
+    if (found != index.end()) {
+        entries.erase(found->second);
+        index.erase(found);
+    } else if (entries.size() >= capacity) {
+        index.erase(entries.back().hash);
+        entries.pop_back();
+    }
+
+    Entry entry;
+    entry.hash = code;
+    entry.key.reserve(genome.size());
+    for (GenomeView run : {genome.head(), genome.genes(), genome.tail()}) {
+        for (unsigned int i = 0; i < run.size(); i++) {
+            entry.key.push_back(quantize(run.data()[i]));
+        }
+    }
+    entry.fitness = fitness;
+
+    entries.push_front(std::move(entry));
+    index[code] = entries.begin();
+}
+
+void FitnessCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    hits = 0;
+    misses = 0;
+}
+
+std::size_t FitnessCache::getCapacity() const
+{
+    return capacity;
+}
+
+double FitnessCache::getResolution() const
+{
+    return resolution;
+}
+
+std::size_t FitnessCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+unsigned long FitnessCache::getHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+unsigned long FitnessCache::getMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+std::int64_t FitnessCache::quantize(double value) const
+{
+    if (resolution > 0) {
+        return static_cast<std::int64_t>(std::floor(value / resolution));
+    }
+
+    // Without a resolution only bit-identical genomes share an entry.
+    std::int64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+std::uint64_t FitnessCache::hash(GenomeView genome) const
+{
+    // FNV-1a over the quantized genes, followed by a final avalanche so the
+    // low bits used by the table are well mixed.
+    std::uint64_t code = 0xCBF29CE484222325ULL;
+    for (GenomeView run : {genome.head(), genome.genes(), genome.tail()}) {
+        for (unsigned int i = 0; i < run.size(); i++) {
+            code = (code ^ static_cast<std::uint64_t>(quantize(run.data()[i]))) * 0x100000001B3ULL;
+        }
+    }
+
+    code ^= code >> 33;
+    code *= 0xFF51AFD7ED558CCDULL;
+    code ^= code >> 33;
+    return code;
+}
+
+bool FitnessCache::matches(const Entry& entry, GenomeView genome) const
+{
+    if (entry.key.size() != genome.size()) {
+        return false;
+    }
+
+    const std::int64_t* key = entry.key.data();
+    for (GenomeView run : {genome.head(), genome.genes(), genome.tail()}) {
+        for (unsigned int i = 0; i < run.size(); i++) {
+            if (*key++ != quantize(run.data()[i])) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
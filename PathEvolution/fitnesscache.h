@@ -0,0 +1,56 @@
+#ifndef FITNESSCACHE_H
+#define FITNESSCACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "population.h"
+
+// Bounded memo of objective values. Genomes are quantized to a grid of the
+// given resolution, so trials closer than that to an evaluated genome (and on
+// the same side of the grid lines) reuse its fitness; a resolution of zero
+// only matches identical genomes. The least recently used
+// entry is evicted when full. Safe to use from several threads.
+class FitnessCache
+{
+private:
+    struct Entry {
+        std::uint64_t hash;
+        std::vector<std::int64_t> key;
+        double fitness;
+    };
+
+    std::size_t capacity;
+    double resolution;
+
+    std::list<Entry> entries;
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+    mutable std::mutex mutex;
+
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+
+public:
+    FitnessCache(std::size_t capacity, double resolution);
+
+    // Writes the cached fitness of genome and returns true if there is one.
+    bool lookup(GenomeView genome, double& fitness);
+    void insert(GenomeView genome, double fitness);
+    void clear();
+
+    std::size_t getCapacity() const;
+    double getResolution() const;
+    std::size_t size() const;
+    unsigned long getHits() const;
+    unsigned long getMisses() const;
+
+private:
+    std::int64_t quantize(double value) const;
+    std::uint64_t hash(GenomeView genome) const;
+    bool matches(const Entry& entry, GenomeView genome) const;
+};
+
+#endif // FITNESSCACHE_H
@@ -0,0 +1,180 @@
+#include "islandevolver.h"
+#include <algorithm>
+#include <thread>
+
+IslandEvolver::Island::Island(double crossoverRate, double scalingFactor)
+    : evolver(crossoverRate, scalingFactor), mailbox(nullptr)
+{
+
+}
+
+IslandEvolver::Island::~Island()
+{
+    delete mailbox.exchange(nullptr);
+}
+
+IslandEvolver::IslandEvolver(unsigned int islandCount, double crossoverRate, double scalingFactor)
+{
+    for (unsigned int i = 0; i < islandCount; i++) {
+        islands.emplace_back(new Island(crossoverRate, scalingFactor));
+    }
+}
+
+void IslandEvolver::initialize(unsigned int popSize, unsigned int dimensionality,
+                               double min, double max, const Individual& prefix, const Individual& suffix)
+{
+    for (unsigned int i = 0; i < islands.size(); i++) {
+        Island& island = *islands[i];
+        island.random = Random::stream(seed, i);
+        island.evolver.setSeed(island.random.next());
+        island.evolver.initialize(popSize, dimensionality, min, max, prefix, suffix);
+        delete island.mailbox.exchange(nullptr);
+    }
+}
+
+void IslandEvolver::setObjectiveFunction(ObjectiveFunction function)
+{
+    for (std::unique_ptr<Island>& island : islands) {
+        island->evolver.setObjectiveFunction(function);
+    }
+}
+
+void IslandEvolver::setBatchObjectiveFunction(BatchObjectiveFunction function)
+{
+    for (std::unique_ptr<Island>& island : islands) {
+        island->evolver.setBatchObjectiveFunction(function);
+    }
+}
+
+void IslandEvolver::setMigration(unsigned int interval, unsigned int migrants, IslandEvolver::Topology topology)
+{
+    this->migrationInterval = interval;
+    this->migrantCount = migrants;
+    this->topology = topology;
+}
+
+void IslandEvolver::setSeed(std::uint64_t seed)
+{
+    this->seed = seed;
+}
+
+unsigned int IslandEvolver::getIslandCount() const
+{
+    return islands.size();
+}
+
+DifferentialEvolver& IslandEvolver::getIsland(unsigned int index)
+{
+    return islands[index]->evolver;
+}
+
+void IslandEvolver::evolve(unsigned int generations)
+{
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < islands.size(); i++) {
+        threads.emplace_back(&IslandEvolver::evolveIsland, this, i, generations);
+    }
+
+    evolveIsland(0, generations);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void IslandEvolver::evolveIsland(unsigned int index, unsigned int generations)
+{
+    DifferentialEvolver& evolver = islands[index]->evolver;
+
+    // A finished island's generation stops advancing, so going on would only
+    // send the same migrants again at every step.
+    for (unsigned int i = 0; i < generations && !evolver.isFinished(); i++) {
+        immigrate(index);
+        evolver.improve();
+
+        if (islands.size() > 1 && migrationInterval > 0 && evolver.getGeneration() % migrationInterval == 0) {
+            emigrate(index);
+        }
+    }
+}
+
+void IslandEvolver::emigrate(unsigned int index)
+{
+    Island& island = *islands[index];
+    PopulationView population = island.evolver.getPopulation();
+
+    std::vector<unsigned int> order(population.size());
+    for (unsigned int i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    unsigned int count = std::min<unsigned int>(migrantCount, order.size());
+    std::partial_sort(order.begin(), order.begin() + count, order.end(), [&](unsigned int a, unsigned int b) {
+        return population.getFitness(a) > population.getFitness(b);
+    });
+
+    Migrants* migrants = new Migrants;
+    for (unsigned int i = 0; i < count; i++) {
+        GenomeView genome = population[order[i]];
+        migrants->genomes.insert(migrants->genomes.end(), genome.begin(), genome.end());
+        migrants->fitnesses.push_back(population.getFitness(order[i]));
+    }
+
+    unsigned int destination = (index + 1) % islands.size();
+    if (topology == Topology::Random) {
+        destination = (index + 1 + island.random.index(islands.size() - 1)) % islands.size();
+    }
+
+    // A packet the destination has not picked up yet is stale; drop it.
+    delete islands[destination]->mailbox.exchange(migrants);
+}
+
+void IslandEvolver::immigrate(unsigned int index)
+{
+    Island& island = *islands[index];
+    if (island.mailbox.load() == nullptr) {
+        return;
+    }
+
+    std::unique_ptr<Migrants> migrants(island.mailbox.exchange(nullptr));
+    if (!migrants) {
+        return;
+    }
+
+    unsigned int dimensionality = migrants->genomes.size() / migrants->fitnesses.size();
+    for (unsigned int i = 0; i < migrants->fitnesses.size(); i++) {
+        GenomeView genome(migrants->genomes.data() + i * dimensionality, dimensionality);
+        island.evolver.replaceWorst(genome, migrants->fitnesses[i]);
+    }
+}
+
+GenomeView IslandEvolver::getBestIndividual() const
+{
+    const Island* best = islands.front().get();
+    for (const std::unique_ptr<Island>& island : islands) {
+        if (island->evolver.getBestFitness() > best->evolver.getBestFitness()) {
+            best = island.get();
+        }
+    }
+
+    return best->evolver.getBestIndividual();
+}
+
+double IslandEvolver::getBestFitness() const
+{
+    double best = islands.front()->evolver.getBestFitness();
+    for (const std::unique_ptr<Island>& island : islands) {
+        best = std::max(best, island->evolver.getBestFitness());
+    }
+
+    return best;
+}
+
+unsigned long IslandEvolver::getEvaluations() const
+{
+    unsigned long evaluations = 0;
+    for (const std::unique_ptr<Island>& island : islands) {
+        evaluations += island->evolver.getEvaluations();
+    }
+
+    return evaluations;
+}
@@ -0,0 +1,72 @@
+#ifndef ISLANDEVOLVER_H
+#define ISLANDEVOLVER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "differentialevolver.h"
+
+// Island-model DE: independent sub-populations evolve on their own threads
+// and share nothing in the generation loop. Every migration interval each
+// island sends copies of its best individuals to a neighbour (ring) or to a
+// randomly chosen island, through a single-slot mailbox that is swapped
+// atomically, so no island ever waits for another. Because islands run
+// unsynchronized, when migrants arrive depends on timing and multi-island
+// runs are not bit-for-bit reproducible.
+class IslandEvolver
+{
+public:
+    enum class Topology { Ring, Random };
+    using Individual = DifferentialEvolver::Individual;
+
+private:
+    struct Migrants {
+        std::vector<double> genomes;
+        std::vector<double> fitnesses;
+    };
+
+    struct Island {
+        DifferentialEvolver evolver;
+        std::atomic<Migrants*> mailbox;
+        Random random;
+
+        Island(double crossoverRate, double scalingFactor);
+        ~Island();
+    };
+
+    std::vector<std::unique_ptr<Island>> islands;
+    std::uint64_t seed = Random::DefaultSeed;
+    unsigned int migrationInterval = 20;
+    unsigned int migrantCount = 2;
+    Topology topology = Topology::Ring;
+
+    void evolveIsland(unsigned int index, unsigned int generations);
+    void emigrate(unsigned int index);
+    void immigrate(unsigned int index);
+
+public:
+    IslandEvolver(unsigned int islandCount, double crossoverRate, double scalingFactor);
+
+    // popSize individuals per island.
+    void initialize(unsigned int popSize, unsigned int dimensionality,
+                    double min, double max, const Individual& prefix = Individual(), const Individual& suffix = Individual());
+    // Called concurrently from every island's thread.
+    void setObjectiveFunction(ObjectiveFunction function);
+    void setBatchObjectiveFunction(BatchObjectiveFunction function);
+    void setMigration(unsigned int interval, unsigned int migrants, Topology topology);
+    // Islands get streams derived from this seed. Takes effect at the next initialize().
+    void setSeed(std::uint64_t seed);
+
+    unsigned int getIslandCount() const;
+    DifferentialEvolver& getIsland(unsigned int index);
+
+    // Runs the given number of generations on every island, one thread per
+    // island. Islands that meet a termination criterion stop early.
+    void evolve(unsigned int generations);
+
+    GenomeView getBestIndividual() const;
+    double getBestFitness() const;
+    unsigned long getEvaluations() const;
+};
+
+#endif // ISLANDEVOLVER_H
@@ -0,0 +1,136 @@
+#include "localsearch.h"
+#include <algorithm>
+#include <cmath>
+
+NelderMead::NelderMead(unsigned int dimensionality, double step)
+    : dimensionality(dimensionality), step(step)
+{
+    vertices.resize(static_cast<std::size_t>(dimensionality + 1) * dimensionality);
+    fitnesses.resize(dimensionality + 1);
+    centroid.resize(dimensionality);
+    reflected.resize(dimensionality);
+    candidate.resize(dimensionality);
+}
+
+double NelderMead::maximize(const Function& function, double* point, double fitness, unsigned int budget)
+{
+    unsigned int n = dimensionality;
+    evaluations = 0;
+    if (n == 0 || budget < n + 1) {
+        return fitness;
+    }
+
+    double expansion = 1 + 2.0 / n;
+    double contraction = 0.75 - 1.0 / (2 * n);
+    double shrinkage = 1 - 1.0 / n;
+
+    std::copy(point, point + n, vertex(0));
+    fitnesses[0] = fitness;
+    for (unsigned int i = 1; i <= n; i++) {
+        std::copy(point, point + n, vertex(i));
+        vertex(i)[i - 1] += step;
+        fitnesses[i] = evaluate(function, vertex(i));
+    }
+
+    // Returns the fitness of the vertex moved to centroid + coefficient * (centroid - worst).
+    auto move = [&](double coefficient, std::vector<double>& out, const double* worst) {
+        for (unsigned int j = 0; j < n; j++) {
+            out[j] = centroid[j] + coefficient * (centroid[j] - worst[j]);
+        }
+        return evaluate(function, out.data());
+    };
+
+    std::vector<unsigned int> order(n + 1);
+    while (evaluations + 2 <= budget) {
+        for (unsigned int i = 0; i <= n; i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+            return fitnesses[a] > fitnesses[b];
+        });
+
+        unsigned int best = order[0];
+        unsigned int worst = order[n];
+        unsigned int secondWorst = order[n - 1];
+
+        std::fill(centroid.begin(), centroid.end(), 0.0);
+        for (unsigned int i = 0; i <= n; i++) {
+            if (i != worst) {
+                const double* v = vertex(i);
+                for (unsigned int j = 0; j < n; j++) {
+                    centroid[j] += v[j] / n;
+                }
+            }
+        }
+
+        double* worstVertex = vertex(worst);
+        double reflectedFitness = move(1, reflected, worstVertex);
+
+        if (reflectedFitness > fitnesses[best]) {
+            double expandedFitness = move(expansion, candidate, worstVertex);
+            if (expandedFitness > reflectedFitness) {
+                std::copy(candidate.begin(), candidate.end(), worstVertex);
+                fitnesses[worst] = expandedFitness;
+            } else {
+                std::copy(reflected.begin(), reflected.end(), worstVertex);
+                fitnesses[worst] = reflectedFitness;
+            }
+            continue;
+        }
+
+        if (reflectedFitness > fitnesses[secondWorst]) {
+            std::copy(reflected.begin(), reflected.end(), worstVertex);
+            fitnesses[worst] = reflectedFitness;
+            continue;
+        }
+
+        // Contract outside if the reflection beat the worst vertex, inside otherwise.
+        bool outside = reflectedFitness > fitnesses[worst];
+        double contractedFitness = move(outside ? contraction : -contraction, candidate, worstVertex);
+        if (contractedFitness > (outside ? reflectedFitness : fitnesses[worst])) {
+            std::copy(candidate.begin(), candidate.end(), worstVertex);
+            fitnesses[worst] = contractedFitness;
+            continue;
+        }
+
+        if (evaluations + n > budget) {
+            break;
+        }
+
+        const double* bestVertex = vertex(best);
+        for (unsigned int i = 0; i <= n; i++) {
+            if (i == best) {
+                continue;
+            }
+            double* v = vertex(i);
+            for (unsigned int j = 0; j < n; j++) {
+                v[j] = bestVertex[j] + shrinkage * (v[j] - bestVertex[j]);
+            }
+            fitnesses[i] = evaluate(function, v);
+        }
+    }
+
+    unsigned int best = std::max_element(fitnesses.begin(), fitnesses.end()) - fitnesses.begin();
+    if (fitnesses[best] > fitness) {
+        std::copy(vertex(best), vertex(best) + n, point);
+        return fitnesses[best];
+    }
+
+    return fitness;
+}
+
+unsigned int NelderMead::getEvaluations() const
+{
+    return evaluations;
+}
+
+double* NelderMead::vertex(unsigned int index)
+{
+    return vertices.data() + static_cast<std::size_t>(index) * dimensionality;
+}
+
+double NelderMead::evaluate(const Function& function, const double* point)
+{
+    evaluations++;
+    return function(point);
+}
@@ -0,0 +1,55 @@
+#ifndef LOCALSEARCH_H
+#define LOCALSEARCH_H
+
+#include <functional>
+#include <vector>
+
+// Work done by the memetic local search, kept apart from the global search.
+struct LocalSearchStatistics {
+    unsigned long runs = 0;
+    // Runs that found something better than their starting point.
+    unsigned long improvements = 0;
+    // Also included in the evolver's total.
+    unsigned long evaluations = 0;
+    // Total fitness gained over all runs.
+    double gain = 0;
+    // Seconds spent in local search.
+    double wallTime = 0;
+};
+
+// Derivative-free Nelder-Mead simplex search with the dimension-adaptive
+// coefficients of Gao & Han (2012), which hold up better than the classic
+// ones beyond a handful of dimensions.
+class NelderMead
+{
+public:
+    // Higher is better.
+    using Function = std::function<double(const double* point)>;
+
+private:
+    unsigned int dimensionality;
+    double step;
+    unsigned int evaluations = 0;
+
+    std::vector<double> vertices;
+    std::vector<double> fitnesses;
+    std::vector<double> centroid;
+    std::vector<double> reflected;
+    std::vector<double> candidate;
+
+public:
+    // The initial simplex spans step along every axis from the start point.
+    NelderMead(unsigned int dimensionality, double step);
+
+    // Improves point, whose fitness is given, spending at most budget
+    // evaluations; leaves the best point found in point and returns its fitness.
+    double maximize(const Function& function, double* point, double fitness, unsigned int budget);
+    // Evaluations of the last call to maximize().
+    unsigned int getEvaluations() const;
+
+private:
+    double* vertex(unsigned int index);
+    double evaluate(const Function& function, const double* point);
+};
+
+#endif // LOCALSEARCH_H
@@ -1,10 +1,100 @@
+#include <cerrno>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 #include "window.h"
 #include "util.h"
+#include "pathevaluator.h"
+#include "remoteevaluation.h"
+
+// PathEvolution [--connect host:port]...  runs the planner, evaluating on the given workers too.
+// PathEvolution --worker port [master]    serves evaluations for planners (only the one
+//                                          on host master, if given) until killed.
+namespace {
+    // The port in text, or 0 unless it is a whole number in 1-65535.
+    unsigned short parsePort(const std::string& text)
+    {
+        char* end = nullptr;
+        errno = 0;
+        long port = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || errno == ERANGE || port < 1 || port > 65535) {
+            return 0;
+        }
+
+        return port;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: PathEvolution [--connect host:port]...\n"
+                  << "       PathEvolution --worker port [master]\n";
+    }
+}
 
 int main(int argc, char *argv[])
 {
+    if (argc > 1 && std::string(argv[1]) == "--worker") {
+        if (argc != 3 && argc != 4) {
+            printUsage();
+            return 1;
+        }
+
+        EvaluationWorker worker([](sf::Packet& scenario) {
+            std::shared_ptr<const PathEvaluator> evaluator = PathEvaluator::read(scenario);
+            return evaluator ? PathEvaluator::batchFunction(evaluator) : BatchObjectiveFunction();
+        });
+
+        unsigned short port = parsePort(argv[2]);
+        if (port == 0) {
+            std::cerr << "Invalid port " << argv[2] << "\n";
+            printUsage();
+            return 1;
+        }
+
+        if (!worker.listen(port)) {
+            std::cerr << "Cannot listen on port " << argv[2] << "\n";
+            return 1;
+        }
+
+        if (argc == 4) {
+            sf::IpAddress master(argv[3]);
+            if (master == sf::IpAddress::None) {
+                std::cerr << "Unknown master " << argv[3] << "\n";
+                return 1;
+            }
+            worker.setAllowedMaster(master);
+        }
+
+        worker.run();
+        return 1;
+    }
+
+    // Checked before the window opens.
+    std::vector<std::pair<std::string, unsigned short>> workers;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string address(argv[i + 1]);
+        std::size_t colon = address.rfind(':');
+        if (std::string(argv[i]) != "--connect" || colon == std::string::npos) {
+            std::cerr << "Ignoring " << argv[i] << " " << address << "\n";
+            continue;
+        }
+
+        unsigned short port = parsePort(address.substr(colon + 1));
+        if (port == 0) {
+            std::cerr << "Invalid port in " << address << "\n";
+            printUsage();
+            return 1;
+        }
+
+        workers.emplace_back(address.substr(0, colon), port);
+    }
+
     Window window(1024, 768);
+    for (const std::pair<std::string, unsigned short>& worker : workers) {
+        window.connectWorker(worker.first, worker.second);
+    }
 
     while (window.loop()) {
 
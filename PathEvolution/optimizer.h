@@ -0,0 +1,57 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "population.h"
+#include "statistics.h"
+#include "termination.h"
+
+// Higher is better. With parallel evaluation enabled objectives are called
+// concurrently from several threads, so they must not mutate shared state.
+using ObjectiveFunction = std::function<double(GenomeView)>;
+// Writes the fitness of every row of trials into fitnesses[row]. Parallel
+// runs hand each thread its own block of rows.
+using BatchObjectiveFunction = std::function<void(GenomeMatrixView trials, double* fitnesses)>;
+
+// What callers such as the window need from a population-based optimizer,
+// so that the algorithm can be picked per problem.
+class Optimizer
+{
+public:
+    using Individual = std::vector<double>;
+    // Called on the optimizing thread at the end of every generation.
+    using StatisticsCallback = std::function<void(const GenerationStatistics&)>;
+
+    virtual ~Optimizer() = default;
+
+    // dimensionality counts the fixed prefix and suffix genes too; only the
+    // genes between them are optimized, starting uniformly in [min, max].
+    virtual void initialize(unsigned int popSize, unsigned int dimensionality, double min, double max,
+                            const Individual& prefix = Individual(), const Individual& suffix = Individual()) = 0;
+    virtual void setSeed(std::uint64_t seed) = 0;
+    virtual void setObjectiveFunction(ObjectiveFunction function) = 0;
+    virtual void setBatchObjectiveFunction(BatchObjectiveFunction function) = 0;
+    virtual void setParallelEvaluation(bool enabled, unsigned int threadCount = 0) = 0;
+
+    // Runs one generation; does nothing once the run has finished.
+    virtual void improve() = 0;
+    virtual bool isFinished() const = 0;
+    // Criteria checked after every generation; the run finishes once one is met.
+    virtual void setTermination(const TerminationCriteria& criteria) = 0;
+    // What finished the run, or TerminationReason::None while it goes on.
+    virtual TerminationReason getTerminationReason() const = 0;
+
+    virtual PopulationView getPopulation() const = 0;
+    virtual GenomeView getBestIndividual() const = 0;
+    virtual double getBestFitness() const = 0;
+    virtual double getFitness(unsigned int index) const = 0;
+    virtual unsigned long getGeneration() const = 0;
+    virtual unsigned long getEvaluations() const = 0;
+
+    virtual void setStatisticsCallback(StatisticsCallback callback) = 0;
+    virtual const GenerationStatistics& getStatistics() const = 0;
+};
+
+#endif // OPTIMIZER_H
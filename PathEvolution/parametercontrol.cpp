@@ -0,0 +1,185 @@
+#include "parametercontrol.h"
+#include <algorithm>
+
+namespace {
+    const double jdeScalingRate = 0.1;
+    const double jdeCrossoverRate = 0.1;
+    const double jdeScalingMin = 0.1;
+    const double jdeScalingRange = 0.9;
+}
+
+ParameterControl::ParameterControl(double crossoverRate, double scalingFactor)
+    : crossoverRate(crossoverRate), scalingFactor(scalingFactor)
+{
+
+}
+
+void ParameterControl::setMode(ParameterControl::Mode mode)
+{
+    this->mode = mode;
+    reset(scalingFactors.size());
+}
+
+ParameterControl::Mode ParameterControl::getMode() const
+{
+    return mode;
+}
+
+bool ParameterControl::usesArchive() const
+{
+    return mode == Mode::SHADE || mode == Mode::LSHADE;
+}
+
+void ParameterControl::reset(unsigned int popSize)
+{
+    scalingFactors.assign(popSize, scalingFactor);
+    crossoverRates.assign(popSize, crossoverRate);
+    acceptedScalingFactors.assign(popSize, scalingFactor);
+    acceptedCrossoverRates.assign(popSize, crossoverRate);
+
+    memoryIndex = 0;
+    scalingMemory.assign(memorySize, scalingFactor);
+    crossoverMemory.assign(memorySize, crossoverRate);
+    successfulScalingFactors.clear();
+    successfulCrossoverRates.clear();
+    improvements.clear();
+}
+
+void ParameterControl::sample(Random& random)
+{
+    unsigned int popSize = scalingFactors.size();
+
+    if (mode == Mode::JDE) {
+        for (unsigned int i = 0; i < popSize; i++) {
+            scalingFactors[i] = random.uniform() < jdeScalingRate ?
+                        jdeScalingMin + random.uniform() * jdeScalingRange : acceptedScalingFactors[i];
+            crossoverRates[i] = random.uniform() < jdeCrossoverRate ? random.uniform() : acceptedCrossoverRates[i];
+        }
+    } else if (mode == Mode::SHADE || mode == Mode::LSHADE) {
+        for (unsigned int i = 0; i < popSize; i++) {
+            unsigned int slot = random.index(memorySize);
+
+            crossoverRates[i] = std::min(1.0, std::max(0.0, random.normal(crossoverMemory[slot], 0.1)));
+
+            double f;
+            do {
+                f = random.cauchy(scalingMemory[slot], 0.1);
+            } while (f <= 0);
+            scalingFactors[i] = std::min(1.0, f);
+        }
+    }
+}
+
+void ParameterControl::reportSuccess(unsigned int index, double improvement)
+{
+    if (mode == Mode::JDE) {
+        acceptedScalingFactors[index] = scalingFactors[index];
+        acceptedCrossoverRates[index] = crossoverRates[index];
+    } else if (mode == Mode::SHADE || mode == Mode::LSHADE) {
+        successfulScalingFactors.push_back(scalingFactors[index]);
+        successfulCrossoverRates.push_back(crossoverRates[index]);
+        improvements.push_back(improvement);
+    }
+}
+
+void ParameterControl::update()
+{
+    if (improvements.empty()) {
+        return;
+    }
+
+    double total = 0;
+    for (double improvement : improvements) {
+        total += improvement;
+    }
+
+    // Weighted arithmetic mean for CR, weighted Lehmer mean for F.
+    double crossoverMean = 0;
+    double scalingSquares = 0;
+    double scalingSum = 0;
+    for (unsigned int i = 0; i < improvements.size(); i++) {
+        double weight = total > 0 ? improvements[i] / total : 1.0 / improvements.size();
+        crossoverMean += weight * successfulCrossoverRates[i];
+        scalingSquares += weight * successfulScalingFactors[i] * successfulScalingFactors[i];
+        scalingSum += weight * successfulScalingFactors[i];
+    }
+
+    crossoverMemory[memoryIndex] = crossoverMean;
+    scalingMemory[memoryIndex] = scalingSquares / scalingSum;
+    memoryIndex = (memoryIndex + 1) % memorySize;
+
+    successfulScalingFactors.clear();
+    successfulCrossoverRates.clear();
+    improvements.clear();
+}
+
+void ParameterControl::retain(const std::vector<unsigned int>& indices)
+{
+    std::vector<double>* arrays[] = {&scalingFactors, &crossoverRates, &acceptedScalingFactors, &acceptedCrossoverRates};
+
+    for (std::vector<double>* values : arrays) {
+        std::vector<double> kept;
+        kept.reserve(indices.size());
+        for (unsigned int index : indices) {
+            kept.push_back((*values)[index]);
+        }
+        values->swap(kept);
+    }
+}
+
+const double* ParameterControl::getScalingFactors() const
+{
+    return scalingFactors.data();
+}
+
+const double* ParameterControl::getCrossoverRates() const
+{
+    return crossoverRates.data();
+}
+
+const double* ParameterControl::getAcceptedScalingFactors() const
+{
+    return acceptedScalingFactors.data();
+}
+
+const double* ParameterControl::getAcceptedCrossoverRates() const
+{
+    return acceptedCrossoverRates.data();
+}
+
+unsigned int ParameterControl::getMemorySize() const
+{
+    return memorySize;
+}
+
+unsigned int ParameterControl::getMemoryIndex() const
+{
+    return memoryIndex;
+}
+
+const double* ParameterControl::getScalingMemory() const
+{
+    return scalingMemory.data();
+}
+
+const double* ParameterControl::getCrossoverMemory() const
+{
+    return crossoverMemory.data();
+}
+
+void ParameterControl::restore(unsigned int popSize, const double* scalingFactors, const double* crossoverRates,
+                               const double* acceptedScalingFactors, const double* acceptedCrossoverRates,
+                               unsigned int memoryIndex, const double* scalingMemory, const double* crossoverMemory)
+{
+    this->scalingFactors.assign(scalingFactors, scalingFactors + popSize);
+    this->crossoverRates.assign(crossoverRates, crossoverRates + popSize);
+    this->acceptedScalingFactors.assign(acceptedScalingFactors, acceptedScalingFactors + popSize);
+    this->acceptedCrossoverRates.assign(acceptedCrossoverRates, acceptedCrossoverRates + popSize);
+
+    this->memoryIndex = memoryIndex % memorySize;
+    this->scalingMemory.assign(scalingMemory, scalingMemory + memorySize);
+    this->crossoverMemory.assign(crossoverMemory, crossoverMemory + memorySize);
+    successfulScalingFactors.clear();
+    successfulCrossoverRates.clear();
+    improvements.clear();
+}
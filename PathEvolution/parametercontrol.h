@@ -0,0 +1,76 @@
+#ifndef PARAMETERCONTROL_H
+#define PARAMETERCONTROL_H
+
+#include <vector>
+#include "random.h"
+
+// Chooses the scaling factor F and crossover rate CR used by every target
+// of a generation.
+//  - Fixed: the configured values for everybody.
+//  - JDE: each individual carries its own F/CR, which are occasionally
+//    resampled and kept only if the resulting trial wins (Brest et al. 2006).
+//  - SHADE: F/CR are drawn around a circular memory of means of the values
+//    that produced improvements (Tanabe & Fukunaga 2013).
+//  - LSHADE: SHADE plus linear population size reduction, which is carried
+//    out by the evolver.
+class ParameterControl
+{
+public:
+    enum class Mode { Fixed, JDE, SHADE, LSHADE };
+
+private:
+    Mode mode = Mode::Fixed;
+    double crossoverRate;
+    double scalingFactor;
+
+    std::vector<double> scalingFactors;
+    std::vector<double> crossoverRates;
+
+    // jDE: values that produced the current individual.
+    std::vector<double> acceptedScalingFactors;
+    std::vector<double> acceptedCrossoverRates;
+
+    // SHADE: success history.
+    unsigned int memorySize = 6;
+    unsigned int memoryIndex = 0;
+    std::vector<double> scalingMemory;
+    std::vector<double> crossoverMemory;
+    std::vector<double> successfulScalingFactors;
+    std::vector<double> successfulCrossoverRates;
+    std::vector<double> improvements;
+
+public:
+    ParameterControl(double crossoverRate, double scalingFactor);
+
+    void setMode(Mode mode);
+    Mode getMode() const;
+    bool usesArchive() const;
+
+    // Starts over with popSize individuals; F/CR memories start from the configured values.
+    void reset(unsigned int popSize);
+    // Draws the parameters of the next generation.
+    void sample(Random& random);
+    // Records that the trial of index improved its target by improvement.
+    void reportSuccess(unsigned int index, double improvement);
+    // Ends the generation, updating memories from the recorded successes.
+    void update();
+    // Keeps only the listed individuals, in that order.
+    void retain(const std::vector<unsigned int>& indices);
+
+    const double* getScalingFactors() const;
+    const double* getCrossoverRates() const;
+
+    // State between generations, for checkpoints. The arrays hold one value
+    // per individual, the memories getMemorySize() values.
+    const double* getAcceptedScalingFactors() const;
+    const double* getAcceptedCrossoverRates() const;
+    unsigned int getMemorySize() const;
+    unsigned int getMemoryIndex() const;
+    const double* getScalingMemory() const;
+    const double* getCrossoverMemory() const;
+    void restore(unsigned int popSize, const double* scalingFactors, const double* crossoverRates,
+                 const double* acceptedScalingFactors, const double* acceptedCrossoverRates,
+                 unsigned int memoryIndex, const double* scalingMemory, const double* crossoverMemory);
+};
+
+#endif // PARAMETERCONTROL_H
@@ -0,0 +1,273 @@
+#include "pathevaluator.h"
+#include "bezierbasis.h"
+#include "bezierkernel.h"
+#include "curvebatch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace {
+    const sf::Uint32 scenarioMagic = 0x50415448;
+    const float stageMargin = 20;
+    // Limits on scenarios read from the network.
+    const unsigned int maxStageSide = 16384;
+    const double minInterval = 1e-5;
+    // Smaller batches are sampled one genome at a time: the product pads
+    // every batch to whole registers, and below this it loses to the kernels.
+    const unsigned int minBatchRows = 3;
+}
+
+PathEvaluator::PathEvaluator(const sf::Image& scenario, sf::Vector2f footprint, sf::Vector2f destination,
+                             const PathSettings& settings)
+    : width(scenario.getSize().x), height(scenario.getSize().y),
+      footprint(footprint), destination(destination), settings(settings)
+{
+    occupancySums.assign((width + 1) * (height + 1), 0);
+
+    for (unsigned int y = 0; y < height; y++) {
+        std::uint32_t row = 0;
+        for (unsigned int x = 0; x < width; x++) {
+            sf::Color color = scenario.getPixel(x, y);
+            row += color.a > 0 && color.r + color.g + color.b > 0;
+            occupancySums[(y + 1) * (width + 1) + x + 1] = occupancySums[y * (width + 1) + x + 1] + row;
+        }
+    }
+}
+
+double PathEvaluator::evaluate(GenomeView genome) const
+{
+    // At least two control points as x, y pairs.
+    if (genome.size() < 4 || genome.size() % 2 != 0) {
+        return std::numeric_limits<double>::max() * -1;
+    }
+
+    unsigned int samples = std::round(1 / settings.interval) + 1;
+    unsigned int degree = genome.size() / 2 - 1;
+    std::vector<double> xs(samples);
+    std::vector<double> ys(samples);
+    if (BezierKernelFactory::UniformSampler sampler = BezierKernelFactory::uniformSampler(degree)) {
+        sampler(genome, samples, xs.data(), ys.data());
+    } else {
+        BezierBasis::uniform(degree, samples)->sample(genome, xs.data(), ys.data());
+    }
+
+    return score(xs.data(), ys.data(), 1, samples, sf::Vector2f(genome[0], genome[1]));
+}
+
+void PathEvaluator::evaluate(GenomeMatrixView genomes, double* fitnesses) const
+{
+    if (genomes.rows() == 0) {
+        return;
+    }
+
+    unsigned int genes = genomes.row(0).size();
+    if (genes < 4 || genes % 2 != 0) {
+        std::fill(fitnesses, fitnesses + genomes.rows(), std::numeric_limits<double>::max() * -1);
+        return;
+    }
+
+    if (genomes.rows() < minBatchRows) {
+        for (unsigned int i = 0; i < genomes.rows(); i++) {
+            fitnesses[i] = evaluate(genomes.row(i));
+        }
+        return;
+    }
+
+    unsigned int samples = std::round(1 / settings.interval) + 1;
+    unsigned int degree = genes / 2 - 1;
+    // Reused so that its buffers are only reallocated when batches grow.
+    static thread_local CurveBatch batch;
+    batch.sample(*BezierBasis::uniform(degree, samples), genomes);
+
+    for (unsigned int i = 0; i < genomes.rows(); i++) {
+        GenomeView genome = genomes.row(i);
+        fitnesses[i] = score(batch.x(0) + i, batch.y(0) + i, batch.stride(), samples,
+                             sf::Vector2f(genome[0], genome[1]));
+    }
+}
+
+double PathEvaluator::score(const double* xs, const double* ys, unsigned int stride, unsigned int samples,
+                            sf::Vector2f start) const
+{
+    sf::Vector2f stage = getStageSize();
+    double collisions = 0;
+    double arcLength = 0;
+    double distanceSum = 0;
+
+    // Like the sprite this replaces, the car starts out at the unscaled
+    // first control point and is only placed on the stage from the second step.
+    sf::Vector2f car = start;
+    sf::Vector2f oldPos;
+
+    for (unsigned int i = 0; i < samples; i++) {
+        sf::Vector2f pos(xs[i * stride] * stage.x, ys[i * stride] * stage.y);
+
+        if (i > 0) {
+            sf::Vector2f delta = pos - oldPos;
+            sf::Vector2f deltaDestination = destination - pos;
+
+            arcLength += std::hypot(delta.x / stage.x, delta.y / stage.y);
+            distanceSum += std::hypot(deltaDestination.x / stage.x, deltaDestination.y / stage.y);
+            float angle = std::atan2(delta.y, delta.x);
+
+            car = pos;
+            if (collides(pos, Util::toDegrees(angle) - 90)) {
+                collisions++;
+            }
+        }
+
+        if (collisions > 0 && settings.stopOnCollision) {
+            break;
+        }
+
+        oldPos = pos;
+    }
+
+    sf::Vector2f delta = destination - car;
+    float finalDistance = std::hypot(delta.x / stage.x, delta.y / stage.y);
+
+    collisions = collisions * settings.collisionWeight;
+    finalDistance = finalDistance * settings.distanceWeight;
+    arcLength = arcLength * settings.arcLengthWeight;
+    distanceSum = distanceSum * settings.arcLengthWeight;
+
+    if (settings.minimizeCollisions) {
+        collisions *= -1;
+    }
+
+    if (settings.minimizeArcLength) {
+        arcLength *= -1;
+    }
+
+    if (settings.minimizeDistance) {
+        finalDistance *= -1;
+        distanceSum *= -1;
+    }
+
+    return collisions + arcLength + (settings.finalDistanceOnly ? finalDistance : distanceSum);
+}
+
+bool PathEvaluator::collides(sf::Vector2f position, float angle) const
+{
+    sf::Vector2f stage = getStageSize();
+    sf::FloatRect stageBuffered(-stageMargin, -stageMargin, stage.x + 2 * stageMargin, stage.y + 2 * stageMargin);
+    sf::FloatRect inside(0, 0, stage.x, stage.y);
+    if (!inside.contains(position) && stageBuffered.contains(position)) {
+        return true;
+    }
+
+    // Axis-aligned bounds of the rotated footprint, as sf::Sprite::getGlobalBounds() gives.
+    float radians = angle * Util::pi() / 180;
+    float cosine = std::abs(std::cos(radians));
+    float sine = std::abs(std::sin(radians));
+    float halfWidth = (cosine * footprint.x + sine * footprint.y) / 2;
+    float halfHeight = (sine * footprint.x + cosine * footprint.y) / 2;
+
+    sf::FloatRect bounds(position.x - halfWidth, position.y - halfHeight, 2 * halfWidth, 2 * halfHeight);
+    sf::FloatRect overlap;
+    if (!bounds.intersects(inside, overlap)) {
+        return false;
+    }
+
+    return isAnyOccupied(std::floor(overlap.left), std::floor(overlap.top),
+                         std::ceil(overlap.left + overlap.width), std::ceil(overlap.top + overlap.height));
+}
+
+bool PathEvaluator::isOccupied(sf::Vector2f point) const
+{
+    return isAnyOccupied(point.x, point.y, std::ceil(point.x), std::ceil(point.y));
+}
+
+sf::Vector2f PathEvaluator::getStageSize() const
+{
+    return sf::Vector2f(width, height);
+}
+
+ObjectiveFunction PathEvaluator::function(std::shared_ptr<const PathEvaluator> evaluator)
+{
+    return [evaluator](GenomeView genome) {
+        return evaluator->evaluate(genome);
+    };
+}
+
+BatchObjectiveFunction PathEvaluator::batchFunction(std::shared_ptr<const PathEvaluator> evaluator)
+{
+    return [evaluator](GenomeMatrixView genomes, double* fitnesses) {
+        evaluator->evaluate(genomes, fitnesses);
+    };
+}
+
+void PathEvaluator::write(sf::Packet& packet) const
+{
+    packet << scenarioMagic << width << height << footprint.x << footprint.y << destination.x << destination.y
+           << settings.collisionWeight << settings.distanceWeight << settings.arcLengthWeight
+           << settings.minimizeCollisions << settings.minimizeDistance << settings.finalDistanceOnly
+           << settings.minimizeArcLength << settings.stopOnCollision << settings.interval;
+
+    // One bit per pixel, row-major.
+    std::string occupancy((width * height + 7) / 8, '\0');
+    for (unsigned int y = 0; y < height; y++) {
+        for (unsigned int x = 0; x < width; x++) {
+            if (isAnyOccupied(x, y, x, y)) {
+                unsigned int bit = y * width + x;
+                occupancy[bit / 8] |= 1 << (bit % 8);
+            }
+        }
+    }
+    packet << occupancy;
+}
+
+std::shared_ptr<const PathEvaluator> PathEvaluator::read(sf::Packet& packet)
+{
+    std::shared_ptr<PathEvaluator> evaluator(new PathEvaluator);
+    PathSettings& settings = evaluator->settings;
+    sf::Uint32 magic = 0;
+    std::string occupancy;
+
+    packet >> magic >> evaluator->width >> evaluator->height >> evaluator->footprint.x >> evaluator->footprint.y
+           >> evaluator->destination.x >> evaluator->destination.y
+           >> settings.collisionWeight >> settings.distanceWeight >> settings.arcLengthWeight
+           >> settings.minimizeCollisions >> settings.minimizeDistance >> settings.finalDistanceOnly
+           >> settings.minimizeArcLength >> settings.stopOnCollision >> settings.interval >> occupancy;
+
+    // Everything here comes from the peer. The bounds keep the sizes below
+    // from overflowing and the allocations sane.
+    unsigned int width = evaluator->width;
+    unsigned int height = evaluator->height;
+    if (!packet || magic != scenarioMagic || width > maxStageSide || height > maxStageSide ||
+        !(settings.interval >= minInterval && settings.interval <= 1) ||
+        occupancy.size() != (static_cast<std::size_t>(width) * height + 7) / 8) {
+        return nullptr;
+    }
+
+    std::vector<std::uint32_t>& sums = evaluator->occupancySums;
+    sums.assign(static_cast<std::size_t>(width + 1) * (height + 1), 0);
+    for (unsigned int y = 0; y < height; y++) {
+        std::uint32_t row = 0;
+        for (unsigned int x = 0; x < width; x++) {
+            std::size_t bit = static_cast<std::size_t>(y) * width + x;
+            row += (occupancy[bit / 8] >> (bit % 8)) & 1;
+            sums[(y + 1) * (width + 1) + x + 1] = sums[y * (width + 1) + x + 1] + row;
+        }
+    }
+
+    return evaluator;
+}
+
+bool PathEvaluator::isAnyOccupied(int left, int top, int right, int bottom) const
+{
+    // Inclusive pixel bounds, clipped to the stage.
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, static_cast<int>(width) - 1);
+    bottom = std::min(bottom, static_cast<int>(height) - 1);
+    if (left > right || top > bottom) {
+        return false;
+    }
+
+    unsigned int stride = width + 1;
+    std::uint32_t count = occupancySums[(bottom + 1) * stride + right + 1] - occupancySums[top * stride + right + 1] -
+                          occupancySums[(bottom + 1) * stride + left] + occupancySums[top * stride + left];
+    return count > 0;
+}
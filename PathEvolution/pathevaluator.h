@@ -0,0 +1,80 @@
+#ifndef PATHEVALUATOR_H
+#define PATHEVALUATOR_H
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "optimizer.h"
+#include "util.h"
+
+// Objective weights and switches, read once from the pane when a run starts.
+struct PathSettings {
+    float collisionWeight = 1;
+    float distanceWeight = 1;
+    float arcLengthWeight = 1;
+    bool minimizeCollisions = true;
+    bool minimizeDistance = true;
+    // Distance to the destination at the end of the path instead of summed along it.
+    bool finalDistanceOnly = false;
+    bool minimizeArcLength = true;
+    bool stopOnCollision = false;
+    // Spacing of the curve samples, both ends included.
+    double interval = 0.005;
+};
+
+// Scores the Bezier path given by a genome of normalized control points
+// without a window: the scenario is kept as an immutable occupancy grid with
+// a summed-area table, and the car as the footprint of its sprite. Nothing
+// is modified by an evaluation, so one evaluator can be shared by any
+// number of threads.
+class PathEvaluator
+{
+private:
+    unsigned int width = 0;
+    unsigned int height = 0;
+    // (width + 1) x (height + 1) prefix sums of occupied pixels.
+    std::vector<std::uint32_t> occupancySums;
+    sf::Vector2f footprint;
+    sf::Vector2f destination;
+    PathSettings settings;
+
+    PathEvaluator() = default;
+
+public:
+    // scenario covers the whole stage; pixels that are neither transparent
+    // nor black are obstacles. footprint is the unrotated size of the car.
+    PathEvaluator(const sf::Image& scenario, sf::Vector2f footprint, sf::Vector2f destination,
+                  const PathSettings& settings);
+
+    double evaluate(GenomeView genome) const;
+    // Samples the whole batch together through CurveBatch, or genome by
+    // genome when it is too small for that to pay off.
+    void evaluate(GenomeMatrixView genomes, double* fitnesses) const;
+
+    // Whether the car centred at position, heading at angle degrees, hits an
+    // obstacle or the area just outside the stage.
+    bool collides(sf::Vector2f position, float angle) const;
+    bool isOccupied(sf::Vector2f point) const;
+    sf::Vector2f getStageSize() const;
+
+    // Objectives that keep the evaluator alive.
+    static ObjectiveFunction function(std::shared_ptr<const PathEvaluator> evaluator);
+    static BatchObjectiveFunction batchFunction(std::shared_ptr<const PathEvaluator> evaluator);
+
+    // Scenario packets for evaluation workers.
+    void write(sf::Packet& packet) const;
+    // Returns nullptr if the packet does not hold a scenario.
+    static std::shared_ptr<const PathEvaluator> read(sf::Packet& packet);
+
+private:
+    // Fitness of the path sampled at xs[i * stride], ys[i * stride], the car
+    // starting at start.
+    double score(const double* xs, const double* ys, unsigned int stride, unsigned int samples,
+                 sf::Vector2f start) const;
+    bool isAnyOccupied(int left, int top, int right, int bottom) const;
+};
+
+#endif // PATHEVALUATOR_H
@@ -0,0 +1,64 @@
+#include "population.h"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace {
+    const unsigned int doublesPerLine = Population::CacheLine / sizeof(double);
+}
+
+std::uint64_t Population::strideFor(unsigned int dimensionality)
+{
+    return (static_cast<std::uint64_t>(dimensionality) + doublesPerLine - 1) / doublesPerLine * doublesPerLine;
+}
+
+void Population::resize(unsigned int count, unsigned int dimensionality)
+{
+    this->count = count;
+    this->dimensionality = dimensionality;
+    rowStride = strideFor(dimensionality);
+
+    // Fitness arrays are padded as well so that every section starts on its own line.
+    std::size_t matrixSize = static_cast<std::size_t>(count) * rowStride;
+    std::size_t fitnessSize = ((count + doublesPerLine - 1) / doublesPerLine) * doublesPerLine;
+    std::size_t total = 2 * matrixSize + 2 * fitnessSize;
+
+    storage.reset(new char[total * sizeof(double) + CacheLine]);
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage.get());
+    address = (address + CacheLine - 1) & ~static_cast<std::uintptr_t>(CacheLine - 1);
+
+    genomes = reinterpret_cast<double*>(address);
+    trials = genomes + matrixSize;
+    fitnesses = trials + matrixSize;
+    trialFitnesses = fitnesses + fitnessSize;
+
+    std::memset(genomes, 0, total * sizeof(double));
+    for (unsigned int i = 0; i < count; i++) {
+        fitnesses[i] = std::numeric_limits<double>::max() * -1;
+        trialFitnesses[i] = std::numeric_limits<double>::max() * -1;
+    }
+}
+
+void Population::setFixedGenes(const std::vector<double>& prefix, const std::vector<double>& suffix)
+{
+    this->prefix = prefix;
+    this->suffix = suffix;
+}
+
+void Population::acceptTrial(unsigned int index)
+{
+    std::memcpy(genome(index), trial(index), dimensionality * sizeof(double));
+    fitnesses[index] = trialFitnesses[index];
+}
+
+void Population::retain(const std::vector<unsigned int>& indices)
+{
+    for (unsigned int i = 0; i < indices.size(); i++) {
+        if (indices[i] != i) {
+            std::memcpy(genome(i), genome(indices[i]), dimensionality * sizeof(double));
+            fitnesses[i] = fitnesses[indices[i]];
+        }
+    }
+
+    count = indices.size();
+}
@@ -0,0 +1,198 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+
+// Non-owning, read-only view over the genes of one genome. The genes may be
+// split in up to three runs: a fixed head, the evolved genes and a fixed
+// tail, which lets optimizers keep constant coordinates out of their genomes
+// while objectives still see the whole thing, without copies.
+class GenomeView
+{
+private:
+    const double* headValues = nullptr;
+    unsigned int headLength = 0;
+    const double* values = nullptr;
+    unsigned int length = 0;
+    const double* tailValues = nullptr;
+    unsigned int tailLength = 0;
+
+public:
+    class Iterator
+    {
+    private:
+        const GenomeView* view;
+        unsigned int index;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = double;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const double*;
+        using reference = double;
+
+        Iterator(const GenomeView* view, unsigned int index) : view(view), index(index) {}
+
+        double operator*() const { return (*view)[index]; }
+        Iterator& operator++() { index++; return *this; }
+        Iterator operator++(int) { Iterator old = *this; index++; return old; }
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+    };
+
+    GenomeView() = default;
+    GenomeView(const double* values, unsigned int length) : values(values), length(length) {}
+    GenomeView(const std::vector<double>& values) : values(values.data()), length(values.size()) {}
+    // values preceded by head and followed by tail, which must be contiguous.
+    GenomeView(GenomeView head, const double* values, unsigned int length, GenomeView tail) :
+        headValues(head.values), headLength(head.length), values(values), length(length),
+        tailValues(tail.values), tailLength(tail.length) {}
+
+    // Finds the run of every gene it is asked for; loops over many genes
+    // should go through the runs or copyTo() instead.
+    double operator[](unsigned int index) const {
+        if (index < headLength) {
+            return headValues[index];
+        }
+        index -= headLength;
+        return index < length ? values[index] : tailValues[index - length];
+    }
+    unsigned int size() const { return headLength + length + tailLength; }
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, size()); }
+
+    // The three runs, each a contiguous view.
+    GenomeView head() const { return GenomeView(headValues, headLength); }
+    GenomeView genes() const { return GenomeView(values, length); }
+    GenomeView tail() const { return GenomeView(tailValues, tailLength); }
+    // The evolved genes, which are the whole genome if isContiguous().
+    const double* data() const { return values; }
+    bool isContiguous() const { return headLength == 0 && tailLength == 0; }
+
+    // Writes all size() genes to out, one block copy per run.
+    void copyTo(double* out) const {
+        out = std::copy(headValues, headValues + headLength, out);
+        out = std::copy(values, values + length, out);
+        std::copy(tailValues, tailValues + tailLength, out);
+    }
+
+    std::vector<double> toVector() const {
+        std::vector<double> genome(size());
+        copyTo(genome.data());
+        return genome;
+    }
+};
+
+// Non-owning, read-only view over consecutive genomes stored row-major.
+class GenomeMatrixView
+{
+private:
+    const double* values = nullptr;
+    unsigned int rowCount = 0;
+    unsigned int columnCount = 0;
+    unsigned int rowStride = 0;
+    GenomeView head;
+    GenomeView tail;
+
+public:
+    GenomeMatrixView() = default;
+    // Rows of columns evolved genes; row() puts the fixed head and tail around them.
+    GenomeMatrixView(const double* values, unsigned int rows, unsigned int columns, unsigned int stride,
+                     GenomeView head = GenomeView(), GenomeView tail = GenomeView()) :
+        values(values), rowCount(rows), columnCount(columns), rowStride(stride), head(head), tail(tail) {}
+
+    unsigned int rows() const { return rowCount; }
+    unsigned int columns() const { return columnCount; }
+    unsigned int stride() const { return rowStride; }
+    const double* data() const { return values; }
+    const double* rowData(unsigned int index) const { return values + index * rowStride; }
+    GenomeView row(unsigned int index) const { return GenomeView(head, rowData(index), columnCount, tail); }
+    GenomeView prefix() const { return head; }
+    GenomeView suffix() const { return tail; }
+    // The rows first to first + rows - 1.
+    GenomeMatrixView slice(unsigned int first, unsigned int rows) const {
+        return GenomeMatrixView(rowData(first), rows, columnCount, rowStride, head, tail);
+    }
+};
+
+// Population, trial buffer and fitnesses of an evolutionary run kept in one
+// contiguous, cache-line-aligned block. Genomes are stored row-major, each
+// row padded to a whole number of cache lines, followed by the trial rows
+// and then the two fitness arrays.
+class Population
+{
+public:
+    static const unsigned int CacheLine = 64;
+
+private:
+    std::unique_ptr<char[]> storage;
+    double* genomes = nullptr;
+    double* trials = nullptr;
+    double* fitnesses = nullptr;
+    double* trialFitnesses = nullptr;
+    unsigned int count = 0;
+    unsigned int dimensionality = 0;
+    unsigned int rowStride = 0;
+    std::vector<double> prefix;
+    std::vector<double> suffix;
+
+public:
+    // Doubles per row for dimensionality genes, padded to whole cache lines.
+    static std::uint64_t strideFor(unsigned int dimensionality);
+
+    // Rows hold dimensionality evolved genes each.
+    void resize(unsigned int count, unsigned int dimensionality);
+    // Constant genes placed before and after every genome in the views.
+    void setFixedGenes(const std::vector<double>& prefix, const std::vector<double>& suffix);
+    const std::vector<double>& getPrefix() const { return prefix; }
+    const std::vector<double>& getSuffix() const { return suffix; }
+
+    unsigned int size() const { return count; }
+    unsigned int getDimensionality() const { return dimensionality; }
+    unsigned int getStride() const { return rowStride; }
+
+    double* genome(unsigned int index) { return genomes + index * rowStride; }
+    const double* genome(unsigned int index) const { return genomes + index * rowStride; }
+    double* trial(unsigned int index) { return trials + index * rowStride; }
+    const double* trial(unsigned int index) const { return trials + index * rowStride; }
+
+    double& fitness(unsigned int index) { return fitnesses[index]; }
+    double fitness(unsigned int index) const { return fitnesses[index]; }
+    double& trialFitness(unsigned int index) { return trialFitnesses[index]; }
+    double trialFitness(unsigned int index) const { return trialFitnesses[index]; }
+    const double* fitnessData() const { return fitnesses; }
+
+    // Whole genomes, fixed genes included.
+    GenomeView genomeView(unsigned int index) const { return GenomeView(prefix, genome(index), dimensionality, suffix); }
+    GenomeView trialView(unsigned int index) const { return GenomeView(prefix, trial(index), dimensionality, suffix); }
+    GenomeMatrixView trialMatrix(unsigned int first, unsigned int rows) const {
+        return GenomeMatrixView(trial(first), rows, dimensionality, rowStride, prefix, suffix);
+    }
+
+    // Replaces the genome and fitness at index with its trial.
+    void acceptTrial(unsigned int index);
+    // Keeps only the listed individuals, given in ascending order, without reallocating.
+    void retain(const std::vector<unsigned int>& indices);
+};
+
+// Lightweight read-only view of a population handed out by optimizers.
+class PopulationView
+{
+private:
+    const Population* population = nullptr;
+
+public:
+    PopulationView() = default;
+    explicit PopulationView(const Population& population) : population(&population) {}
+
+    unsigned int size() const { return population ? population->size() : 0; }
+    GenomeView operator[](unsigned int index) const { return population->genomeView(index); }
+    double getFitness(unsigned int index) const { return population->fitness(index); }
+};
+
+#endif // POPULATION_H
@@ -0,0 +1,120 @@
+#include "random.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    std::uint64_t splitMix(std::uint64_t& x)
+    {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    const double pi = 3.14159265358979323846;
+}
+
+Random::Random(std::uint64_t seed)
+{
+    for (std::uint64_t& word : state) {
+        word = splitMix(seed);
+    }
+}
+
+Random Random::stream(std::uint64_t seed, std::uint64_t a, std::uint64_t b, std::uint64_t c)
+{
+    // Each id is folded in through a full SplitMix64 round, so streams that
+    // differ in a single id end up with unrelated states.
+    std::uint64_t key = seed;
+    for (std::uint64_t id : {a, b, c}) {
+        std::uint64_t mixed = id;
+        key = splitMix(key) ^ splitMix(mixed);
+    }
+
+    return Random(key);
+}
+
+void Random::fillUniform(double* out, unsigned int count, double min, double max)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        out[i] = uniform(min, max);
+    }
+}
+
+void Random::fillMask(unsigned char* out, unsigned int count, double probability)
+{
+    // Comparing the raw 53-bit draws against a scaled threshold avoids the
+    // integer-to-double conversion of uniform().
+    double scaled = std::max(0.0, std::min(1.0, probability)) * 9007199254740992.0;
+    std::uint64_t threshold = static_cast<std::uint64_t>(scaled);
+
+    for (unsigned int i = 0; i < count; i++) {
+        out[i] = (next() >> 11) < threshold;
+    }
+}
+
+void Random::sampleDistinct(unsigned int max, unsigned int quantity, const unsigned int* excluded,
+                            unsigned int excludedCount, unsigned int* out)
+{
+    // Rejection would never end once the allowed values run out.
+    unsigned int available = max;
+    for (unsigned int i = 0; i < excludedCount; i++) {
+        if (excluded[i] < max && std::find(excluded, excluded + i, excluded[i]) == excluded + i) {
+            available--;
+        }
+    }
+
+    unsigned int distinct = std::min(quantity, available);
+    unsigned int drawn = 0;
+
+    while (drawn < distinct) {
+        unsigned int element = index(max);
+
+        if (std::find(excluded, excluded + excludedCount, element) == excluded + excludedCount &&
+            std::find(out, out + drawn, element) == out + drawn) {
+            out[drawn++] = element;
+        }
+    }
+
+    while (drawn < quantity) {
+        out[drawn++] = index(max);
+    }
+}
+
+double Random::normal(double mean, double deviation)
+{
+    double u = 1 - uniform();
+    double v = uniform();
+    return mean + deviation * std::sqrt(-2 * std::log(u)) * std::cos(2 * pi * v);
+}
+
+double Random::cauchy(double location, double scale)
+{
+    return location + scale * std::tan(pi * (uniform() - 0.5));
+}
+
+void Random::jump()
+{
+    static const std::uint64_t polynomial[] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+
+    std::uint64_t jumped[4] = {0, 0, 0, 0};
+    for (std::uint64_t word : polynomial) {
+        for (int bit = 0; bit < 64; bit++) {
+            if (word & (static_cast<std::uint64_t>(1) << bit)) {
+                for (int i = 0; i < 4; i++) {
+                    jumped[i] ^= state[i];
+                }
+            }
+            next();
+        }
+    }
+
+    setState(jumped);
+}
+
+void Random::setState(const std::uint64_t* state)
+{
+    std::copy(state, state + 4, this->state);
+}
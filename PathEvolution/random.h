@@ -0,0 +1,87 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <initializer_list>
+
+// xoshiro256** generator (Blackman & Vigna). Small, fast and with 2^256 - 1
+// period. Independent streams are derived from a master seed and a few stream
+// ids by hashing them through SplitMix64, so e.g. every (generation, individual)
+// pair of a run gets its own reproducible sequence regardless of which thread
+// consumes it.
+class Random
+{
+public:
+    using result_type = std::uint64_t;
+    static const std::uint64_t DefaultSeed = 5489;
+
+private:
+    std::uint64_t state[4];
+
+public:
+    explicit Random(std::uint64_t seed = DefaultSeed);
+
+    // Generator for the stream identified by (a, b, c) under seed.
+    static Random stream(std::uint64_t seed, std::uint64_t a, std::uint64_t b = 0, std::uint64_t c = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+    result_type operator()() { return next(); }
+
+    std::uint64_t next() {
+        const std::uint64_t result = rotate(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotate(state[3], 45);
+
+        return result;
+    }
+
+    // Uniform in [0, 1) with 53 random bits.
+    double uniform() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    double uniform(double min, double max) {
+        return min + (max - min) * uniform();
+    }
+
+    // Uniform integer in [0, bound), by multiply-shift on 32 random bits.
+    unsigned int index(unsigned int bound) {
+        return static_cast<unsigned int>(((next() >> 32) * bound) >> 32);
+    }
+
+    void fillUniform(double* out, unsigned int count, double min = 0, double max = 1);
+    // out[i] = 1 with the given probability, 0 otherwise; used for crossover masks.
+    void fillMask(unsigned char* out, unsigned int count, double probability);
+    // Writes quantity distinct values from [0, max) that are not in excluded
+    // to out. Rejection sampling with linear scans, so meant for small quantities.
+    // If the range holds fewer than quantity such values, the remaining ones
+    // are drawn from all of [0, max) and may repeat.
+    void sampleDistinct(unsigned int max, unsigned int quantity, const unsigned int* excluded,
+                        unsigned int excludedCount, unsigned int* out);
+    void sampleDistinct(unsigned int max, unsigned int quantity, std::initializer_list<unsigned int> excluded, unsigned int* out) {
+        sampleDistinct(max, quantity, excluded.begin(), excluded.size(), out);
+    }
+
+    double normal(double mean, double deviation);
+    double cauchy(double location, double scale);
+
+    // Advances the generator by 2^128 steps.
+    void jump();
+
+    const std::uint64_t* getState() const { return state; }
+    void setState(const std::uint64_t* state);
+
+private:
+    static std::uint64_t rotate(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+#endif // RANDOM_H
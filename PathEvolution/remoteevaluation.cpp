@@ -0,0 +1,354 @@
+#include "remoteevaluation.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+namespace {
+    enum MessageType : sf::Uint8 { SetupMessage = 1, ReadyMessage, BatchMessage, ResultMessage };
+    const sf::Uint32 protocolVersion = 1;
+}
+
+void RemoteEvaluator::setScenario(const sf::Packet& scenario)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->scenario = scenario;
+
+    for (std::unique_ptr<Worker>& worker : workers) {
+        if (worker->alive && !sendScenario(*worker)) {
+            std::deque<unsigned int> none;
+            drop(*worker, none);
+        }
+    }
+}
+
+bool RemoteEvaluator::connect(const std::string& host, unsigned short port)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<Worker> worker(new Worker);
+    worker->address = host + ":" + std::to_string(port);
+
+    if (worker->socket.connect(host, port, timeout) != sf::Socket::Done) {
+        std::cerr << "Worker " << worker->address << " is unreachable" << std::endl;
+        return false;
+    }
+    if (scenario.getDataSize() > 0 && !sendScenario(*worker)) {
+        std::cerr << "Worker " << worker->address << " rejected the scenario" << std::endl;
+        return false;
+    }
+
+    selector.add(worker->socket);
+    workers.push_back(std::move(worker));
+    return true;
+}
+
+void RemoteEvaluator::disconnect()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    selector.clear();
+    workers.clear();
+}
+
+void RemoteEvaluator::setFallback(BatchObjectiveFunction fallback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->fallback = fallback;
+}
+
+void RemoteEvaluator::setPipelineDepth(unsigned int depth)
+{
+    pipelineDepth = std::max(1u, depth);
+}
+
+void RemoteEvaluator::setBatchSize(unsigned int rows)
+{
+    batchSize = rows;
+}
+
+void RemoteEvaluator::setTimeout(sf::Time timeout)
+{
+    this->timeout = timeout;
+}
+
+unsigned int RemoteEvaluator::getWorkerCount() const
+{
+    return std::count_if(workers.begin(), workers.end(), [](const std::unique_ptr<Worker>& worker) {
+        return worker->alive;
+    });
+}
+
+unsigned long RemoteEvaluator::getRemoteEvaluations() const
+{
+    return remoteEvaluations;
+}
+
+unsigned long RemoteEvaluator::getLocalEvaluations() const
+{
+    return localEvaluations;
+}
+
+void RemoteEvaluator::evaluate(GenomeMatrixView trials, double* fitnesses)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    unsigned int rows = trials.rows();
+    unsigned int alive = getWorkerCount();
+
+    if (alive == 0) {
+        evaluateLocally(trials, Batch{0, rows}, fitnesses);
+        return;
+    }
+
+    unsigned int pipelines = alive * pipelineDepth;
+    if (batchSize == 0 && rows < pipelines && !warnedSmallCalls) {
+        warnedSmallCalls = true;
+        std::cerr << "Remote evaluation got " << rows << " genomes for " << pipelines
+                  << " pipelines; pass whole generations to keep the workers busy" << std::endl;
+    }
+
+    unsigned int size = batchSize > 0 ? batchSize : std::max(1u, (rows + pipelines - 1) / pipelines);
+    std::vector<Batch> batches;
+    std::deque<unsigned int> pending;
+    for (unsigned int first = 0; first < rows; first += size) {
+        pending.push_back(batches.size());
+        batches.push_back(Batch{first, std::min(size, rows - first)});
+    }
+
+    unsigned int remaining = batches.size();
+    while (remaining > 0) {
+        bool waiting = false;
+        for (std::unique_ptr<Worker>& worker : workers) {
+            while (worker->alive && worker->outstanding.size() < pipelineDepth && !pending.empty()) {
+                if (send(*worker, trials, batches, pending.front())) {
+                    pending.pop_front();
+                } else {
+                    drop(*worker, pending);
+                }
+            }
+            waiting = waiting || !worker->outstanding.empty();
+        }
+
+        if (!waiting) {
+            // Every worker is gone.
+            for (unsigned int batch : pending) {
+                evaluateLocally(trials, batches[batch], fitnesses);
+            }
+            return;
+        }
+
+        if (!selector.wait(timeout)) {
+            for (std::unique_ptr<Worker>& worker : workers) {
+                if (!worker->outstanding.empty()) {
+                    std::cerr << "Worker " << worker->address << " timed out" << std::endl;
+                    drop(*worker, pending);
+                }
+            }
+            continue;
+        }
+
+        for (std::unique_ptr<Worker>& worker : workers) {
+            if (worker->alive && !worker->outstanding.empty() && selector.isReady(worker->socket)) {
+                if (receive(*worker, batches, fitnesses)) {
+                    remaining--;
+                } else {
+                    drop(*worker, pending);
+                }
+            }
+        }
+    }
+}
+
+BatchObjectiveFunction RemoteEvaluator::function()
+{
+    return [this](GenomeMatrixView trials, double* fitnesses) {
+        evaluate(trials, fitnesses);
+    };
+}
+
+bool RemoteEvaluator::sendScenario(RemoteEvaluator::Worker& worker)
+{
+    sf::Packet packet;
+    packet << static_cast<sf::Uint8>(SetupMessage) << protocolVersion;
+    packet.append(scenario.getData(), scenario.getDataSize());
+    if (worker.socket.send(packet) != sf::Socket::Done) {
+        return false;
+    }
+
+    sf::SocketSelector reply;
+    reply.add(worker.socket);
+    if (!reply.wait(timeout)) {
+        return false;
+    }
+
+    sf::Packet answer;
+    sf::Uint8 type = 0;
+    bool accepted = false;
+    return worker.socket.receive(answer) == sf::Socket::Done && (answer >> type >> accepted) &&
+            type == ReadyMessage && accepted;
+}
+
+bool RemoteEvaluator::send(RemoteEvaluator::Worker& worker, GenomeMatrixView trials,
+                           const std::vector<Batch>& batches, unsigned int batch)
+{
+    const Batch& rows = batches[batch];
+    unsigned int columns = trials.row(0).size();
+
+    sf::Packet packet;
+    packet << static_cast<sf::Uint8>(BatchMessage) << sequence
+           << static_cast<sf::Uint32>(rows.rows) << static_cast<sf::Uint32>(columns);
+    for (unsigned int i = rows.first; i < rows.first + rows.rows; i++) {
+        for (double gene : trials.row(i)) {
+            packet << gene;
+        }
+    }
+
+    if (worker.socket.send(packet) != sf::Socket::Done) {
+        return false;
+    }
+
+    worker.outstanding.push_back(Request{sequence++, batch});
+    return true;
+}
+
+bool RemoteEvaluator::receive(RemoteEvaluator::Worker& worker, const std::vector<Batch>& batches, double* fitnesses)
+{
+    sf::Packet packet;
+    if (worker.socket.receive(packet) != sf::Socket::Done) {
+        return false;
+    }
+
+    // Workers answer in order, so the reply belongs to the oldest request.
+    const Request& request = worker.outstanding.front();
+    const Batch& batch = batches[request.batch];
+    sf::Uint8 type = 0;
+    sf::Uint32 id = 0;
+    sf::Uint32 rows = 0;
+    if (!(packet >> type >> id >> rows) || type != ResultMessage || id != request.sequence || rows != batch.rows) {
+        return false;
+    }
+
+    std::vector<double> values(rows);
+    for (double& value : values) {
+        packet >> value;
+    }
+    if (!packet) {
+        return false;
+    }
+
+    std::copy(values.begin(), values.end(), fitnesses + batch.first);
+    remoteEvaluations += rows;
+    worker.outstanding.pop_front();
+    return true;
+}
+
+void RemoteEvaluator::drop(RemoteEvaluator::Worker& worker, std::deque<unsigned int>& pending)
+{
+    if (worker.alive) {
+        selector.remove(worker.socket);
+        worker.socket.disconnect();
+        worker.alive = false;
+    }
+
+    for (auto request = worker.outstanding.rbegin(); request != worker.outstanding.rend(); ++request) {
+        pending.push_front(request->batch);
+    }
+    worker.outstanding.clear();
+}
+
+void RemoteEvaluator::evaluateLocally(GenomeMatrixView trials, const RemoteEvaluator::Batch& batch, double* fitnesses)
+{
+    if (fallback) {
+        fallback(trials.slice(batch.first, batch.rows), fitnesses + batch.first);
+    } else {
+        std::fill(fitnesses + batch.first, fitnesses + batch.first + batch.rows, std::numeric_limits<double>::max() * -1);
+    }
+
+    localEvaluations += batch.rows;
+}
+
+EvaluationWorker::EvaluationWorker(EvaluationWorker::Setup setup) : setup(setup)
+{
+
+}
+
+bool EvaluationWorker::listen(unsigned short port)
+{
+    return listener.listen(port) == sf::Socket::Done;
+}
+
+void EvaluationWorker::setAllowedMaster(const sf::IpAddress& address)
+{
+    allowedMaster = address;
+}
+
+void EvaluationWorker::run()
+{
+    while (true) {
+        sf::TcpSocket master;
+        if (listener.accept(master) != sf::Socket::Done) {
+            return;
+        }
+
+        if (allowedMaster != sf::IpAddress::Any && master.getRemoteAddress() != allowedMaster) {
+            std::cout << "Refusing " << master.getRemoteAddress() << std::endl;
+            continue;
+        }
+
+        std::cout << "Serving " << master.getRemoteAddress() << std::endl;
+        serve(master);
+    }
+}
+
+void EvaluationWorker::serve(sf::TcpSocket& master)
+{
+    BatchObjectiveFunction objective;
+    std::vector<double> genes;
+    std::vector<double> fitnesses;
+
+    sf::Packet packet;
+    while (master.receive(packet) == sf::Socket::Done) {
+        sf::Uint8 type = 0;
+        packet >> type;
+
+        sf::Packet reply;
+        if (type == SetupMessage) {
+            sf::Uint32 version = 0;
+            packet >> version;
+            objective = version == protocolVersion ? setup(packet) : BatchObjectiveFunction();
+            reply << static_cast<sf::Uint8>(ReadyMessage) << static_cast<bool>(objective);
+        } else if (type == BatchMessage && objective) {
+            sf::Uint32 id = 0;
+            sf::Uint32 rows = 0;
+            sf::Uint32 columns = 0;
+            packet >> id >> rows >> columns;
+
+            // The sizes come from the peer; whatever genes they announce
+            // must at least be in the packet.
+            std::uint64_t count = static_cast<std::uint64_t>(rows) * columns;
+            if (!packet || columns == 0 || count > MaxBatchGenes || count * sizeof(double) > packet.getDataSize()) {
+                return;
+            }
+
+            genes.resize(count);
+            for (double& gene : genes) {
+                packet >> gene;
+            }
+            if (!packet) {
+                return;
+            }
+
+            fitnesses.assign(rows, std::numeric_limits<double>::max() * -1);
+            objective(GenomeMatrixView(genes.data(), rows, columns, columns), fitnesses.data());
+
+            reply << static_cast<sf::Uint8>(ResultMessage) << id << rows;
+            for (double fitness : fitnesses) {
+                reply << fitness;
+            }
+        } else {
+            return;
+        }
+
+        if (master.send(reply) != sf::Socket::Done) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef REMOTEEVALUATION_H
+#define REMOTEEVALUATION_H
+
+#include <SFML/Network.hpp>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "optimizer.h"
+
+// Master side of distributed evaluation. Batches of genomes are shipped to
+// worker processes over TCP and the fitness arrays they send back are
+// written in place. Several batches are kept in flight per worker, so a
+// worker always has the next one queued when it finishes the current one.
+// Batches of a worker that disconnects or stops answering, and every batch
+// once no worker is left, are evaluated by the local fallback.
+//
+// Genes travel in host byte order, so workers must run on machines with the
+// same floating-point representation as the master.
+class RemoteEvaluator
+{
+private:
+    struct Batch {
+        unsigned int first;
+        unsigned int rows;
+    };
+
+    struct Request {
+        sf::Uint32 sequence;
+        unsigned int batch;
+    };
+
+    struct Worker {
+        sf::TcpSocket socket;
+        std::string address;
+        std::deque<Request> outstanding;
+        bool alive = true;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    sf::SocketSelector selector;
+    sf::Packet scenario;
+    BatchObjectiveFunction fallback;
+
+    unsigned int pipelineDepth = 3;
+    unsigned int batchSize = 0;
+    sf::Time timeout = sf::seconds(30);
+    sf::Uint32 sequence = 0;
+
+    unsigned long remoteEvaluations = 0;
+    unsigned long localEvaluations = 0;
+    bool warnedSmallCalls = false;
+    std::mutex mutex;
+
+public:
+    // Sent to every worker when it connects and whenever it changes; workers
+    // build their objective from it. Workers connected before the first
+    // scenario is set get it with that.
+    void setScenario(const sf::Packet& scenario);
+    // Returns false if the worker cannot be reached or rejects the scenario.
+    bool connect(const std::string& host, unsigned short port);
+    void disconnect();
+
+    void setFallback(BatchObjectiveFunction fallback);
+    // Batches in flight per worker.
+    void setPipelineDepth(unsigned int depth);
+    // Rows per batch; zero splits every call evenly over the pipelines.
+    void setBatchSize(unsigned int rows);
+    // How long to wait for any reply before giving up on the busy workers.
+    void setTimeout(sf::Time timeout);
+
+    unsigned int getWorkerCount() const;
+    unsigned long getRemoteEvaluations() const;
+    unsigned long getLocalEvaluations() const;
+
+    // Calls are serialized and only spread over the workers within a call,
+    // so every call should carry a whole generation. DifferentialEvolver does
+    // that with parallel evaluation off; a pool would split each generation
+    // into blocks that queue up here one after another. Warns once on calls
+    // too small to fill every worker's pipeline.
+    void evaluate(GenomeMatrixView trials, double* fitnesses);
+    // evaluate() as an objective for setBatchObjectiveFunction(). The
+    // evaluator must outlive the optimizer using it.
+    BatchObjectiveFunction function();
+
+private:
+    bool sendScenario(Worker& worker);
+    bool send(Worker& worker, GenomeMatrixView trials, const std::vector<Batch>& batches, unsigned int batch);
+    bool receive(Worker& worker, const std::vector<Batch>& batches, double* fitnesses);
+    void drop(Worker& worker, std::deque<unsigned int>& pending);
+    void evaluateLocally(GenomeMatrixView trials, const Batch& batch, double* fitnesses);
+};
+
+// Worker side: a separate process that listens for a master, builds its
+// objective from the scenario the master sends and answers batches with
+// their fitnesses until the master goes away.
+class EvaluationWorker
+{
+public:
+    // Reads the scenario, positioned after the protocol header; returns an
+    // empty function to reject it.
+    using Setup = std::function<BatchObjectiveFunction(sf::Packet& scenario)>;
+
+    // Largest batch a master may send, in genes.
+    static const sf::Uint32 MaxBatchGenes = 1 << 24;
+
+private:
+    Setup setup;
+    sf::TcpListener listener;
+    sf::IpAddress allowedMaster = sf::IpAddress::Any;
+
+public:
+    EvaluationWorker(Setup setup);
+
+    bool listen(unsigned short port);
+    // Only serves masters connecting from address; Any, the default, lets
+    // everybody in.
+    void setAllowedMaster(const sf::IpAddress& address);
+    // Serves masters one after another; returns only if accepting fails.
+    void run();
+    // Serves one connected master until it disconnects.
+    void serve(sf::TcpSocket& master);
+};
+
+#endif // REMOTEEVALUATION_H
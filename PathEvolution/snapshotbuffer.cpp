@@ -0,0 +1,16 @@
+#include "snapshotbuffer.h"
+
+void PopulationSnapshot::capture(const Optimizer& optimizer)
+{
+    PopulationView population = optimizer.getPopulation();
+    dimensionality = population.size() > 0 ? population[0].size() : 0;
+    generation = optimizer.getGeneration();
+    bestFitness = optimizer.getBestFitness();
+
+    genomes.resize(population.size() * dimensionality);
+    fitnesses.clear();
+    for (unsigned int i = 0; i < population.size(); i++) {
+        population[i].copyTo(genomes.data() + i * dimensionality);
+        fitnesses.push_back(population.getFitness(i));
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef SNAPSHOTBUFFER_H
+#define SNAPSHOTBUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "optimizer.h"
+
+// Hands immutable values from one writer to any number of readers without
+// locks. The writer fills a slot nobody is reading and publishes it by
+// swapping the index of the latest slot; readers pin the latest slot with a
+// reference count while they use it. Neither side ever waits for the other:
+// if every spare slot is pinned, publish() drops the value instead. With
+// slotCount slots, slotCount - 2 snapshots can be held at once without
+// publications being dropped.
+template <class T>
+class SnapshotBuffer
+{
+private:
+    struct Slot {
+        T value;
+        unsigned long sequence = 0;
+        std::atomic<unsigned int> readers;
+
+        Slot() : readers(0) {}
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    unsigned int slotCount;
+    std::atomic<int> latest;
+    unsigned long published = 0;
+
+public:
+    // A pinned published value; the slot is released when this goes away.
+    class Snapshot
+    {
+    private:
+        Slot* slot = nullptr;
+
+    public:
+        Snapshot() = default;
+        explicit Snapshot(Slot* slot) : slot(slot) {}
+        Snapshot(Snapshot&& other) : slot(other.slot) { other.slot = nullptr; }
+        Snapshot& operator=(Snapshot&& other) {
+            std::swap(slot, other.slot);
+            return *this;
+        }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        ~Snapshot() {
+            if (slot) {
+                slot->readers.fetch_sub(1);
+            }
+        }
+
+        explicit operator bool() const { return slot != nullptr; }
+        const T& operator*() const { return slot->value; }
+        const T* operator->() const { return &slot->value; }
+        // Increases with every publication, starting at 1.
+        unsigned long sequence() const { return slot->sequence; }
+    };
+
+    explicit SnapshotBuffer(unsigned int slotCount = 3) :
+        slots(new Slot[std::max(2u, slotCount)]), slotCount(std::max(2u, slotCount)), latest(-1) {}
+
+    // Writer side, from a single thread. fill(T&) overwrites a free slot,
+    // which still holds an older value that it may reuse. Returns false if
+    // no slot was free and nothing was published.
+    template <class Fill>
+    bool publish(Fill fill) {
+        int current = latest.load();
+        for (unsigned int i = 0; i < slotCount; i++) {
+            if (static_cast<int>(i) != current && slots[i].readers.load() == 0) {
+                fill(slots[i].value);
+                slots[i].sequence = ++published;
+                latest.store(i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Reader side, from any thread. Empty until something is published.
+    Snapshot read() {
+        while (true) {
+            int index = latest.load();
+            if (index < 0) {
+                return Snapshot();
+            }
+
+            // The slot may have been retired between the load and the pin;
+            // it is only safe to read if it is still the latest afterwards.
+            slots[index].readers.fetch_add(1);
+            if (latest.load() == index) {
+                return Snapshot(&slots[index]);
+            }
+            slots[index].readers.fetch_sub(1);
+        }
+    }
+};
+
+// Copy of an optimizer's population, whole genomes included, for consumers
+// that must not touch the optimizer while it runs.
+struct PopulationSnapshot {
+    std::vector<double> genomes;
+    std::vector<double> fitnesses;
+    unsigned int dimensionality = 0;
+    unsigned long generation = 0;
+    double bestFitness = 0;
+
+    unsigned int size() const { return fitnesses.size(); }
+    GenomeView operator[](unsigned int index) const {
+        return GenomeView(genomes.data() + index * dimensionality, dimensionality);
+    }
+    double getFitness(unsigned int index) const { return fitnesses[index]; }
+
+    // Reuses the storage of the previous capture.
+    void capture(const Optimizer& optimizer);
+};
+
+#endif // SNAPSHOTBUFFER_H
@@ -0,0 +1,42 @@
+#include "statistics.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+void GenerationStatistics::measure(const Population& population, unsigned int begin, unsigned int end, double best)
+{
+    unsigned int count = population.size();
+    this->best = best;
+
+    double sum = 0;
+    double squares = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        sum += population.fitness(i);
+        squares += population.fitness(i) * population.fitness(i);
+    }
+    mean = sum / count;
+    deviation = std::sqrt(std::max(0.0, squares / count - mean * mean));
+
+    std::vector<double> centroid(end - begin, 0.0);
+    for (unsigned int i = 0; i < count; i++) {
+        const double* genome = population.genome(i);
+        for (unsigned int k = begin; k < end; k++) {
+            centroid[k - begin] += genome[k];
+        }
+    }
+    for (double& value : centroid) {
+        value /= count;
+    }
+
+    double distances = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        const double* genome = population.genome(i);
+        double distance = 0;
+        for (unsigned int k = begin; k < end; k++) {
+            double delta = genome[k] - centroid[k - begin];
+            distance += delta * delta;
+        }
+        distances += std::sqrt(distance);
+    }
+    diversity = distances / count;
+}
@@ -0,0 +1,25 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "population.h"
+
+// Summary of one finished generation.
+struct GenerationStatistics {
+    unsigned long generation = 0;
+    double best = 0;
+    double mean = 0;
+    double deviation = 0;
+    // Mean Euclidean distance of the evolved genes to their centroid.
+    double diversity = 0;
+    // Trials that replaced their target this generation.
+    unsigned int improvements = 0;
+    // Evaluations since initialization.
+    unsigned long evaluations = 0;
+    // Seconds since initialization.
+    double wallTime = 0;
+
+    // Fills best, mean, deviation and diversity from the genes in [begin, end).
+    void measure(const Population& population, unsigned int begin, unsigned int end, double best);
+};
+
+#endif // STATISTICS_H
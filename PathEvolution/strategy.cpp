@@ -0,0 +1,66 @@
+#include "strategy.h"
+
+namespace {
+    struct Entry {
+        std::string name;
+        TrialGenerator generator;
+        unsigned int minimumPopSize;
+    };
+
+    template <class Mutation, class Crossover>
+    Entry entry()
+    {
+        using Generated = Strategy<Mutation, Crossover>;
+        return {Generated::name(), &Generated::buildTrial, Generated::minimumPopSize()};
+    }
+
+    const std::vector<Entry>& registry()
+    {
+        static const std::vector<Entry> strategies{
+            entry<Rand1Mutation, BinomialCrossover>(),
+            entry<Rand1Mutation, ExponentialCrossover>(),
+            entry<Best1Mutation, BinomialCrossover>(),
+            entry<Best1Mutation, ExponentialCrossover>(),
+            entry<CurrentToBest1Mutation, BinomialCrossover>(),
+            entry<CurrentToBest1Mutation, ExponentialCrossover>(),
+            entry<CurrentToPBest1Mutation, BinomialCrossover>(),
+            entry<CurrentToPBest1Mutation, ExponentialCrossover>(),
+            entry<Rand2Mutation, BinomialCrossover>(),
+            entry<Rand2Mutation, ExponentialCrossover>(),
+        };
+
+        return strategies;
+    }
+}
+
+TrialGenerator StrategyFactory::create(const std::string& name)
+{
+    for (const Entry& strategy : registry()) {
+        if (strategy.name == name) {
+            return strategy.generator;
+        }
+    }
+
+    return nullptr;
+}
+
+unsigned int StrategyFactory::minimumPopSize(const std::string& name)
+{
+    for (const Entry& strategy : registry()) {
+        if (strategy.name == name) {
+            return strategy.minimumPopSize;
+        }
+    }
+
+    return 0;
+}
+
+std::vector<std::string> StrategyFactory::getNames()
+{
+    std::vector<std::string> names;
+    for (const Entry& strategy : registry()) {
+        names.push_back(strategy.name);
+    }
+
+    return names;
+}
@@ -0,0 +1,215 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <string>
+#include <vector>
+#include "population.h"
+#include <algorithm>
+#include "random.h"
+
+// Everything a strategy needs to build the trial vector of one target.
+// Only the genes in [begin, end) are evolved; the others are copied from
+// the target unchanged. F and CR are given per target.
+struct TrialContext {
+    Population* population;
+    unsigned int begin;
+    unsigned int end;
+    unsigned int best;
+    const double* scalingFactors;
+    const double* crossoverRates;
+
+    // Indices sorted from best to worst; the first pBestCount form the p-best set.
+    const unsigned int* ranking;
+    unsigned int pBestCount;
+
+    // Genomes replaced by their trials, row-major with the population's stride.
+    const double* archive;
+    unsigned int archiveSize;
+};
+
+// Mutation policies. prepare() picks the donor genomes for a target and
+// mutant() combines them into the mutant value of gene k. All randomness
+// comes from the generator of the target's stream.
+
+struct Rand1Mutation {
+    static const unsigned int Donors = 3;
+    static const char* name() { return "rand/1"; }
+
+    static void prepare(const TrialContext& context, unsigned int target, const double** donors, Random& random) {
+        unsigned int agents[3];
+        random.sampleDistinct(context.population->size(), 3, {target}, agents);
+        for (unsigned int i = 0; i < 3; i++) {
+            donors[i] = context.population->genome(agents[i]);
+        }
+    }
+
+    static double mutant(const double* const* donors, unsigned int k, double f) {
+        return donors[0][k] + f * (donors[1][k] - donors[2][k]);
+    }
+};
+
+struct Best1Mutation {
+    static const unsigned int Donors = 3;
+    static const char* name() { return "best/1"; }
+
+    static void prepare(const TrialContext& context, unsigned int target, const double** donors, Random& random) {
+        unsigned int agents[2];
+        random.sampleDistinct(context.population->size(), 2, {target, context.best}, agents);
+        donors[0] = context.population->genome(context.best);
+        donors[1] = context.population->genome(agents[0]);
+        donors[2] = context.population->genome(agents[1]);
+    }
+
+    static double mutant(const double* const* donors, unsigned int k, double f) {
+        return donors[0][k] + f * (donors[1][k] - donors[2][k]);
+    }
+};
+
+struct CurrentToBest1Mutation {
+    static const unsigned int Donors = 4;
+    static const char* name() { return "current-to-best/1"; }
+
+    static void prepare(const TrialContext& context, unsigned int target, const double** donors, Random& random) {
+        unsigned int agents[2];
+        random.sampleDistinct(context.population->size(), 2, {target, context.best}, agents);
+        donors[0] = context.population->genome(target);
+        donors[1] = context.population->genome(context.best);
+        donors[2] = context.population->genome(agents[0]);
+        donors[3] = context.population->genome(agents[1]);
+    }
+
+    static double mutant(const double* const* donors, unsigned int k, double f) {
+        return donors[0][k] + f * (donors[1][k] - donors[0][k]) + f * (donors[2][k] - donors[3][k]);
+    }
+};
+
+// JADE/SHADE mutation: the best-vector is one of the top p%, and the last
+// donor may also come from the archive of replaced parents.
+struct CurrentToPBest1Mutation {
+    static const unsigned int Donors = 4;
+    static const char* name() { return "current-to-pbest/1"; }
+
+    static void prepare(const TrialContext& context, unsigned int target, const double** donors, Random& random) {
+        const Population& population = *context.population;
+        unsigned int pBest = context.ranking[random.index(context.pBestCount)];
+        unsigned int first;
+        unsigned int second;
+        random.sampleDistinct(population.size(), 1, {target}, &first);
+        random.sampleDistinct(population.size() + context.archiveSize, 1, {target, first}, &second);
+
+        donors[0] = population.genome(target);
+        donors[1] = population.genome(pBest);
+        donors[2] = population.genome(first);
+        donors[3] = second < population.size() ? population.genome(second) :
+                                                 context.archive + (second - population.size()) * population.getStride();
+    }
+
+    static double mutant(const double* const* donors, unsigned int k, double f) {
+        return donors[0][k] + f * (donors[1][k] - donors[0][k]) + f * (donors[2][k] - donors[3][k]);
+    }
+};
+
+struct Rand2Mutation {
+    static const unsigned int Donors = 5;
+    static const char* name() { return "rand/2"; }
+
+    static void prepare(const TrialContext& context, unsigned int target, const double** donors, Random& random) {
+        unsigned int agents[5];
+        random.sampleDistinct(context.population->size(), 5, {target}, agents);
+        for (unsigned int i = 0; i < 5; i++) {
+            donors[i] = context.population->genome(agents[i]);
+        }
+    }
+
+    static double mutant(const double* const* donors, unsigned int k, double f) {
+        return donors[0][k] + f * (donors[1][k] - donors[2][k]) + f * (donors[3][k] - donors[4][k]);
+    }
+};
+
+// Crossover policies. Both produce a per-gene selection mask that is applied
+// with a select instead of a branch, so the gene loop has no data-dependent jumps.
+
+struct BinomialCrossover {
+    static const unsigned int MaskChunk = 64;
+    static const char* name() { return "bin"; }
+
+    template <class Mutation>
+    static void apply(const TrialContext& context, double f, double cr, const double* current, const double* const* donors, double* trial, Random& random) {
+        unsigned int forced = context.begin + random.index(context.end - context.begin);
+        unsigned char mask[MaskChunk];
+
+        for (unsigned int chunk = context.begin; chunk < context.end; chunk += MaskChunk) {
+            unsigned int last = std::min(context.end, chunk + MaskChunk);
+            random.fillMask(mask, last - chunk, cr);
+
+            for (unsigned int k = chunk; k < last; k++) {
+                bool take = mask[k - chunk] || k == forced;
+                double mutated = Mutation::mutant(donors, k, f);
+                trial[k] = take ? mutated : current[k];
+            }
+        }
+    }
+};
+
+struct ExponentialCrossover {
+    static const char* name() { return "exp"; }
+
+    template <class Mutation>
+    static void apply(const TrialContext& context, double f, double cr, const double* current, const double* const* donors, double* trial, Random& random) {
+        unsigned int length = context.end - context.begin;
+        unsigned int start = random.index(length);
+        unsigned int run = 1;
+        while (run < length && random.uniform() < cr) {
+            run++;
+        }
+
+        for (unsigned int k = context.begin; k < context.end; k++) {
+            unsigned int offset = (k - context.begin + length - start) % length;
+            double mutated = Mutation::mutant(donors, k, f);
+            trial[k] = offset < run ? mutated : current[k];
+        }
+    }
+};
+
+// DE/<mutation>/<crossover>, fixed at compile time.
+template <class Mutation, class Crossover>
+struct Strategy {
+    static std::string name() {
+        return std::string("DE/") + Mutation::name() + "/" + Crossover::name();
+    }
+
+    // Smallest population the donors can always be drawn from, target excluded.
+    static unsigned int minimumPopSize() {
+        return std::max(4u, Mutation::Donors + 1);
+    }
+
+    static void buildTrial(const TrialContext& context, unsigned int target, Random& random) {
+        const double* donors[Mutation::Donors];
+        Mutation::prepare(context, target, donors, random);
+
+        Population& population = *context.population;
+        const double* current = population.genome(target);
+        double* trial = population.trial(target);
+        unsigned int dimensionality = population.getDimensionality();
+
+        std::copy(current, current + context.begin, trial);
+        Crossover::template apply<Mutation>(context, context.scalingFactors[target], context.crossoverRates[target],
+                                            current, donors, trial, random);
+        std::copy(current + context.end, current + dimensionality, trial + context.end);
+    }
+};
+
+using TrialGenerator = void (*)(const TrialContext& context, unsigned int target, Random& random);
+
+// Maps strategy names such as "DE/rand/1/bin" to their instantiations.
+class StrategyFactory
+{
+public:
+    // Returns nullptr for unknown names.
+    static TrialGenerator create(const std::string& name);
+    // Strategy<...>::minimumPopSize() of the named strategy; 0 for unknown names.
+    static unsigned int minimumPopSize(const std::string& name);
+    static std::vector<std::string> getNames();
+};
+
+#endif // STRATEGY_H
@@ -0,0 +1,97 @@
+#include "surrogate.h"
+#include <algorithm>
+
+Surrogate::Surrogate(unsigned int capacity, unsigned int neighbours)
+    : capacity(std::max(1u, capacity)), neighbours(std::max(1u, std::min(neighbours, MaxNeighbours)))
+{
+
+}
+
+void Surrogate::add(GenomeView genome, double fitness)
+{
+    if (columns != genome.size()) {
+        clear();
+        columns = genome.size();
+        genomes.resize(static_cast<std::size_t>(capacity) * columns);
+        fitnesses.resize(capacity);
+    }
+
+    genome.copyTo(genomes.data() + static_cast<std::size_t>(next) * columns);
+    fitnesses[next] = fitness;
+    next = (next + 1) % capacity;
+    count = std::min(count + 1, capacity);
+}
+
+bool Surrogate::predict(GenomeView genome, double& fitness) const
+{
+    if (count < neighbours || genome.size() != columns) {
+        return false;
+    }
+
+    // Nearest samples so far, sorted by squared distance.
+    double distances[MaxNeighbours] = {};
+    unsigned int indices[MaxNeighbours];
+    unsigned int found = 0;
+
+    for (unsigned int i = 0; i < count; i++) {
+        const double* sample = genomes.data() + static_cast<std::size_t>(i) * columns;
+        double distance = 0;
+        for (GenomeView run : {genome.head(), genome.genes(), genome.tail()}) {
+            for (unsigned int j = 0; j < run.size(); j++) {
+                double delta = sample[j] - run.data()[j];
+                distance += delta * delta;
+            }
+            sample += run.size();
+        }
+
+        if (found == neighbours && distance >= distances[found - 1]) {
+            continue;
+        }
+
+        unsigned int position = found < neighbours ? found++ : found - 1;
+        while (position > 0 && distances[position - 1] > distance) {
+            distances[position] = distances[position - 1];
+            indices[position] = indices[position - 1];
+            position--;
+        }
+        distances[position] = distance;
+        indices[position] = i;
+    }
+
+    if (distances[0] == 0) {
+        fitness = fitnesses[indices[0]];
+        return true;
+    }
+
+    double weighted = 0;
+    double total = 0;
+    for (unsigned int i = 0; i < found; i++) {
+        double weight = 1 / distances[i];
+        weighted += weight * fitnesses[indices[i]];
+        total += weight;
+    }
+
+    fitness = weighted / total;
+    return true;
+}
+
+void Surrogate::clear()
+{
+    count = 0;
+    next = 0;
+}
+
+unsigned int Surrogate::size() const
+{
+    return count;
+}
+
+unsigned int Surrogate::getCapacity() const
+{
+    return capacity;
+}
+
+unsigned int Surrogate::getNeighbours() const
+{
+    return neighbours;
+}
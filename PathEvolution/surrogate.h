@@ -0,0 +1,56 @@
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include <vector>
+#include "population.h"
+
+// Counters of a surrogate-assisted run.
+struct SurrogateStatistics {
+    // Trials rejected on the model's word alone; each one is an evaluation saved.
+    unsigned long skipped = 0;
+    // Trials the model rejected but that were evaluated anyway to audit it.
+    unsigned long audited = 0;
+    // Audited trials that did beat their target after all.
+    unsigned long wrongRejections = 0;
+    // Sum of the improvements those wrong rejections would have thrown away.
+    double lostFitness = 0;
+
+    // Fitness lost by the skipped trials, extrapolated from the audited ones.
+    double estimatedLoss() const { return audited > 0 ? lostFitness * skipped / audited : 0; }
+};
+
+// k-nearest-neighbour regression over the most recently evaluated genomes,
+// weighting neighbours by inverse squared distance. Cheap enough to query for
+// every trial of a generation; predict() may be called from several threads
+// as long as nobody is adding samples.
+class Surrogate
+{
+public:
+    static const unsigned int MaxNeighbours = 16;
+
+private:
+    unsigned int capacity;
+    unsigned int neighbours;
+    unsigned int columns = 0;
+    unsigned int count = 0;
+    unsigned int next = 0;
+
+    std::vector<double> genomes;
+    std::vector<double> fitnesses;
+
+public:
+    Surrogate(unsigned int capacity, unsigned int neighbours);
+
+    // Remembers an evaluated genome, replacing the oldest one when full.
+    void add(GenomeView genome, double fitness);
+    // Writes the predicted fitness of genome; returns false while fewer than
+    // neighbours samples are known.
+    bool predict(GenomeView genome, double& fitness) const;
+    void clear();
+
+    unsigned int size() const;
+    unsigned int getCapacity() const;
+    unsigned int getNeighbours() const;
+};
+
+#endif // SURROGATE_H
@@ -0,0 +1,65 @@
+#include "termination.h"
+
+ConvergenceMonitor::ConvergenceMonitor(const TerminationCriteria& criteria)
+    : criteria(criteria)
+{
+    reset();
+}
+
+const TerminationCriteria& ConvergenceMonitor::getCriteria() const
+{
+    return criteria;
+}
+
+void ConvergenceMonitor::reset()
+{
+    history.assign(criteria.stagnationGenerations > 0 ? criteria.stagnationGenerations + 1 : 0, 0);
+    recorded = 0;
+}
+
+TerminationReason ConvergenceMonitor::update(const GenerationStatistics& statistics)
+{
+    if (criteria.maximumEvaluations > 0 && statistics.evaluations >= criteria.maximumEvaluations) {
+        return TerminationReason::EvaluationBudget;
+    }
+
+    if (criteria.maximumTime > 0 && statistics.wallTime >= criteria.maximumTime) {
+        return TerminationReason::TimeBudget;
+    }
+
+    if (criteria.minimumDiversity > 0 && statistics.diversity < criteria.minimumDiversity) {
+        return TerminationReason::DiversityCollapse;
+    }
+
+    if (!history.empty()) {
+        history[recorded % history.size()] = statistics.best;
+        recorded++;
+
+        if (recorded >= history.size()) {
+            double oldest = history[recorded % history.size()];
+            if (statistics.best - oldest < criteria.stagnationEpsilon) {
+                return TerminationReason::Stagnation;
+            }
+        }
+    }
+
+    return TerminationReason::None;
+}
+
+const char* toString(TerminationReason reason)
+{
+    switch (reason) {
+    case TerminationReason::None:
+        return "none";
+    case TerminationReason::Stagnation:
+        return "stagnation";
+    case TerminationReason::DiversityCollapse:
+        return "diversity collapse";
+    case TerminationReason::EvaluationBudget:
+        return "evaluation budget";
+    case TerminationReason::TimeBudget:
+        return "time budget";
+    }
+
+    return "";
+}
@@ -0,0 +1,43 @@
+#ifndef TERMINATION_H
+#define TERMINATION_H
+
+#include <vector>
+#include "statistics.h"
+
+// Conditions that end a run. A zero disables the respective check.
+struct TerminationCriteria {
+    // The best fitness rose by less than stagnationEpsilon over the last
+    // stagnationGenerations generations.
+    unsigned int stagnationGenerations = 0;
+    double stagnationEpsilon = 0;
+    // The population's diversity (see GenerationStatistics) fell below this.
+    double minimumDiversity = 0;
+    unsigned long maximumEvaluations = 0;
+    // Seconds since initialization.
+    double maximumTime = 0;
+};
+
+enum class TerminationReason { None, Stagnation, DiversityCollapse, EvaluationBudget, TimeBudget };
+
+// Checks the statistics of every generation against a set of criteria.
+class ConvergenceMonitor
+{
+private:
+    TerminationCriteria criteria;
+    // Best fitness of the last stagnationGenerations + 1 generations, as a ring.
+    std::vector<double> history;
+    unsigned int recorded = 0;
+
+public:
+    explicit ConvergenceMonitor(const TerminationCriteria& criteria = TerminationCriteria());
+
+    const TerminationCriteria& getCriteria() const;
+    // Forgets the fitness history, e.g. after a restart.
+    void reset();
+    // Returns which criterion, if any, the generation described by statistics meets.
+    TerminationReason update(const GenerationStatistics& statistics);
+};
+
+const char* toString(TerminationReason reason);
+
+#endif // TERMINATION_H
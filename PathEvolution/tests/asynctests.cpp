@@ -0,0 +1,66 @@
+#include "tests.h"
+#include "differentialevolver.h"
+#include <vector>
+
+namespace {
+    double sphere(GenomeView genome)
+    {
+        const double* genes = genome.data();
+        double sum = 0;
+        for (unsigned int i = 0; i < genome.size(); i++) {
+            sum -= genes[i] * genes[i];
+        }
+        return sum;
+    }
+
+    // With one worker the tickets run in order, so runs are reproducible.
+    void start(DifferentialEvolver& evolver, unsigned int threads)
+    {
+        evolver.setObjectiveFunction(sphere);
+        evolver.setParallelEvaluation(true, threads);
+        evolver.setSeed(11);
+        evolver.initialize(50, 30, -5, 5);
+    }
+}
+
+void testAsynchronousEvolution()
+{
+    // Every call takes up the streams where the last one stopped, so split
+    // runs replay a single long one instead of repeating their first draws.
+    DifferentialEvolver split(0.9, 0.5);
+    start(split, 1);
+    split.evolveAsynchronously(5000);
+    double halfway = split.getBestFitness();
+    split.evolveAsynchronously(5000);
+
+    DifferentialEvolver whole(0.9, 0.5);
+    start(whole, 1);
+    whole.evolveAsynchronously(10000);
+
+    check(split.getBestFitness() > halfway, "a second asynchronous call makes progress");
+    check(split.getBestFitness() == whole.getBestFitness(), "two calls of 5000 evaluations replay one of 10000");
+
+    // Statistics describe the population as it is, the last acceptance included.
+    PopulationView population = split.getPopulation();
+    double mean = 0;
+    for (unsigned int i = 0; i < population.size(); i++) {
+        mean += population.getFitness(i);
+    }
+    mean /= population.size();
+    const GenerationStatistics& statistics = split.getStatistics();
+    check(statistics.best == split.getBestFitness(), "statistics report the best individual");
+    check(statistics.mean == mean, "statistics measure the live population");
+
+    // Several workers: exact evaluation counts and steady progress.
+    DifferentialEvolver parallel(0.9, 0.5);
+    start(parallel, 4);
+    unsigned long initial = parallel.getEvaluations();
+    double best = parallel.getBestFitness();
+    for (unsigned int call = 0; call < 4; call++) {
+        parallel.evolveAsynchronously(20000);
+        check(parallel.getEvaluations() == initial + 20000 * (call + 1), "every ticket counts one evaluation");
+        check(parallel.getBestFitness() >= best, "the best individual is never lost");
+        best = parallel.getBestFitness();
+    }
+    check(best > -1e-3, "four workers solve the sphere in 80000 evaluations");
+}
@@ -0,0 +1,67 @@
+#include "tests.h"
+#include "bezierbasis.h"
+#include "bezierkernel.h"
+#include "random.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+    const unsigned int samples = 201;
+
+    // Largest distance of either sampler from the basis table over a few
+    // random curves of the given degree.
+    void drift(unsigned int degree, double& evaluated, double& differenced)
+    {
+        Random random(24);
+        std::vector<double> controls(2 * (degree + 1));
+        std::vector<double> xs(samples), ys(samples), tableXs(samples), tableYs(samples);
+        std::shared_ptr<const BezierBasis> basis = BezierBasis::uniform(degree, samples);
+        BezierKernelFactory::Evaluator evaluator = BezierKernelFactory::evaluator(degree);
+        BezierKernelFactory::UniformSampler sampler = BezierKernelFactory::uniformSampler(degree);
+
+        evaluated = 0;
+        differenced = 0;
+        for (unsigned int curve = 0; curve < 10; curve++) {
+            for (double& control : controls) {
+                control = random.uniform();
+            }
+            GenomeView genome(controls.data(), controls.size());
+            basis->sample(genome, tableXs.data(), tableYs.data());
+
+            if (sampler) {
+                sampler(genome, samples, xs.data(), ys.data());
+            }
+            for (unsigned int i = 0; i < samples; i++) {
+                Point2D point = evaluator(genome, basis->getParameter(i));
+                evaluated = std::max({evaluated, std::abs(point.first - tableXs[i]),
+                                      std::abs(point.second - tableYs[i])});
+                if (sampler) {
+                    differenced = std::max({differenced, std::abs(xs[i] - tableXs[i]),
+                                            std::abs(ys[i] - tableYs[i])});
+                }
+            }
+        }
+    }
+}
+
+void testBezierKernels()
+{
+    double evaluated = 0;
+    double differenced = 0;
+    double worstEvaluated = 0;
+    double worstDifferenced = 0;
+    for (unsigned int degree = 1; degree <= BezierKernelFactory::MaxDegree; degree++) {
+        drift(degree, evaluated, differenced);
+        worstEvaluated = std::max(worstEvaluated, evaluated);
+        if (degree <= BezierKernelFactory::MaxUniformDegree) {
+            worstDifferenced = std::max(worstDifferenced, differenced);
+        }
+    }
+
+    check(!BezierKernelFactory::evaluator(BezierKernelFactory::MaxDegree + 1) &&
+          !BezierKernelFactory::uniformSampler(BezierKernelFactory::MaxUniformDegree + 1),
+          "degrees past the kernels are left to the basis tables");
+    check(worstEvaluated < 1e-14, "Horner's rule agrees with the basis tables to 1e-14");
+    check(worstDifferenced < 1e-8, "forward differencing agrees with the basis tables to 1e-8");
+}
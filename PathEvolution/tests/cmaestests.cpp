@@ -0,0 +1,92 @@
+#include "tests.h"
+#include "cmaes.h"
+#include "differentialevolver.h"
+#include <string>
+
+namespace {
+    const unsigned int dimensionality = 26;
+    const double target = -1e-8;
+
+    double sphere(GenomeView genome)
+    {
+        const double* genes = genome.data();
+        double sum = 0;
+        for (unsigned int i = 0; i < genome.size(); i++) {
+            sum -= genes[i] * genes[i];
+        }
+        return sum;
+    }
+
+    double rosenbrock(GenomeView genome)
+    {
+        const double* genes = genome.data();
+        double sum = 0;
+        for (unsigned int i = 0; i + 1 < genome.size(); i++) {
+            double valley = genes[i + 1] - genes[i] * genes[i];
+            sum -= 100 * valley * valley + (1 - genes[i]) * (1 - genes[i]);
+        }
+        return sum;
+    }
+
+    // Evaluations until the best fitness reaches target, or 0 if the budget
+    // runs out first. Only goes through the Optimizer interface.
+    unsigned long evaluationsToTarget(Optimizer& optimizer, unsigned int popSize, ObjectiveFunction objective,
+                                      unsigned long budget)
+    {
+        TerminationCriteria criteria;
+        criteria.maximumEvaluations = budget;
+        optimizer.setTermination(criteria);
+        optimizer.setSeed(18);
+        optimizer.setObjectiveFunction(objective);
+        optimizer.initialize(popSize, dimensionality, -2, 2);
+
+        while (!optimizer.isFinished()) {
+            optimizer.improve();
+            if (optimizer.getBestFitness() >= target) {
+                return optimizer.getEvaluations();
+            }
+        }
+
+        return 0;
+    }
+
+    unsigned long shade(ObjectiveFunction objective, unsigned long budget)
+    {
+        DifferentialEvolver evolver(0.5, 0.5);
+        evolver.setParameterControl(ParameterControl::Mode::SHADE);
+        return evaluationsToTarget(evolver, 50, objective, budget);
+    }
+
+    unsigned long cmaes(ObjectiveFunction objective, unsigned long budget)
+    {
+        CMAES strategy;
+        return evaluationsToTarget(strategy, 0, objective, budget);
+    }
+
+    std::string counts(unsigned long cma, unsigned long de)
+    {
+        return " (" + std::to_string(cma) + " against " + std::to_string(de) + " evaluations)";
+    }
+}
+
+void testCovarianceMatrixAdaptation()
+{
+    unsigned long cmaSphere = cmaes(sphere, 100000);
+    unsigned long deSphere = shade(sphere, 100000);
+    check(cmaSphere > 0 && deSphere > 0 && cmaSphere < deSphere,
+          "CMA-ES solves the sphere in fewer evaluations than SHADE" + counts(cmaSphere, deSphere));
+
+    unsigned long cmaRosenbrock = cmaes(rosenbrock, 400000);
+    unsigned long deRosenbrock = shade(rosenbrock, 400000);
+    check(cmaRosenbrock > 0 && deRosenbrock > 0 && cmaRosenbrock < deRosenbrock,
+          "CMA-ES solves Rosenbrock in fewer evaluations than SHADE" + counts(cmaRosenbrock, deRosenbrock));
+
+    // Both report why they stopped through the interface.
+    CMAES strategy;
+    DifferentialEvolver evolver(0.5, 0.5);
+    for (Optimizer* optimizer : {static_cast<Optimizer*>(&strategy), static_cast<Optimizer*>(&evolver)}) {
+        check(evaluationsToTarget(*optimizer, 20, rosenbrock, 200) == 0 && optimizer->isFinished() &&
+              optimizer->getTerminationReason() == TerminationReason::EvaluationBudget,
+              "an exhausted budget finishes the run and is reported as its reason");
+    }
+}
@@ -0,0 +1,60 @@
+#include "tests.h"
+#include "differentialevolver.h"
+
+namespace {
+    const unsigned int popSize = 20;
+    const unsigned int generations = 300;
+
+    double shiftedSphere(GenomeView genome)
+    {
+        const double* genes = genome.data();
+        double sum = 0;
+        for (unsigned int i = 0; i < genome.size(); i++) {
+            sum -= (genes[i] - 0.123456) * (genes[i] - 0.123456);
+        }
+        return sum;
+    }
+
+    // A cache as coarse as this one stalls DE well short of the optimum.
+    void run(DifferentialEvolver& evolver, bool refined)
+    {
+        evolver.setObjectiveFunction(shiftedSphere);
+        evolver.setSeed(19);
+        evolver.setFitnessCache(4096, 1e-2);
+        if (refined) {
+            evolver.setLocalSearch(5, 100);
+        }
+        evolver.initialize(popSize, 6, -1, 1);
+
+        for (unsigned int i = 0; i < generations; i++) {
+            evolver.improve();
+        }
+    }
+}
+
+void testLocalSearch()
+{
+    DifferentialEvolver plain(0.9, 0.5);
+    run(plain, false);
+    DifferentialEvolver refined(0.9, 0.5);
+    run(refined, true);
+
+    const LocalSearchStatistics& statistics = refined.getLocalSearchStatistics();
+    check(statistics.runs == generations / 5 && statistics.evaluations > 0, "local search runs every 5 generations");
+    check(refined.getEvaluations() == popSize * generations + statistics.evaluations,
+          "local search evaluations count towards the total");
+    // Through the cache, candidates closer together than its resolution
+    // would get their neighbours' fitness back and the search would stall.
+    check(refined.getBestFitness() > plain.getBestFitness() / 2,
+          "local search refines past the cache resolution");
+
+    // The evaluation budget sees local evaluations too.
+    DifferentialEvolver budgeted(0.9, 0.5);
+    TerminationCriteria criteria;
+    criteria.maximumEvaluations = 2000;
+    budgeted.setTermination(criteria);
+    run(budgeted, true);
+    check(budgeted.getTerminationReason() == TerminationReason::EvaluationBudget &&
+          budgeted.getEvaluations() < criteria.maximumEvaluations + popSize + 100,
+          "a memetic run stops at its evaluation budget");
+}
@@ -0,0 +1,50 @@
+#include "tests.h"
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    unsigned int failures = 0;
+}
+
+bool check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::printf("FAILED: %s\n", what.c_str());
+        failures++;
+    }
+
+    return condition;
+}
+
+// Runs the tests named on the command line, or all of them. Exits with 1 if
+// any check failed.
+int main(int argc, char** argv)
+{
+    const std::vector<std::pair<std::string, void (*)()>> tests{
+        {"async", testAsynchronousEvolution},
+        {"surrogate", testSurrogateScreening},
+        {"replan", testWarmStartReplanning},
+        {"cmaes", testCovarianceMatrixAdaptation},
+        {"localsearch", testLocalSearch},
+        {"remote", testRemoteEvaluation},
+        {"pathevaluator", testPathEvaluator},
+        {"bezier", testBezierKernels}
+    };
+
+    for (const std::pair<std::string, void (*)()>& test : tests) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) {
+            selected = selected || test.first == argv[i];
+        }
+
+        if (selected) {
+            unsigned int before = failures;
+            test.second();
+            std::printf("%s %s\n", failures == before ? "ok    " : "FAILED", test.first.c_str());
+        }
+    }
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,82 @@
+#include "tests.h"
+#include "pathevaluator.h"
+#include "random.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+    const unsigned int rows = 50;
+
+    // A stage with a wall across most of it, so that paths differ in collisions too.
+    sf::Image scenario()
+    {
+        sf::Image image;
+        image.create(160, 120, sf::Color::Transparent);
+        for (unsigned int y = 20; y < 100; y++) {
+            for (unsigned int x = 70; x < 80; x++) {
+                image.setPixel(x, y, sf::Color::White);
+            }
+        }
+        return image;
+    }
+
+    // rows genomes of degree + 1 normalized control points.
+    std::vector<double> genomes(unsigned int degree)
+    {
+        Random random(22);
+        std::vector<double> genes(rows * (degree + 1) * 2);
+        for (double& gene : genes) {
+            gene = random.uniform();
+        }
+        return genes;
+    }
+}
+
+void testPathEvaluator()
+{
+    const double lowest = std::numeric_limits<double>::max() * -1;
+    PathEvaluator evaluator(scenario(), sf::Vector2f(4, 8), sf::Vector2f(150, 110), PathSettings());
+
+    // Unsigned int sizes used to wrap around to an empty occupancy string here.
+    sf::Packet forged;
+    forged << sf::Uint32(0x50415448) << 65536u << 65536u << 1.f << 1.f << 1.f << 1.f << 1.f << 1.f << 1.f
+           << true << true << false << true << false << 0.005 << std::string();
+    check(!PathEvaluator::read(forged), "a 65536x65536 scenario with no occupancy is rejected");
+
+    sf::Packet packet;
+    evaluator.write(packet);
+    std::shared_ptr<const PathEvaluator> copy = PathEvaluator::read(packet);
+    std::vector<double> genes = genomes(5);
+    bool identical = copy != nullptr;
+    for (unsigned int i = 0; identical && i < rows; i++) {
+        GenomeView genome(genes.data() + i * 12, 12);
+        identical = copy->evaluate(genome) == evaluator.evaluate(genome);
+    }
+    check(identical, "a written and re-read scenario scores paths identically");
+
+    double fitnesses[2] = {};
+    evaluator.evaluate(GenomeMatrixView(genes.data(), 2, 3, 3), fitnesses);
+    check(evaluator.evaluate(GenomeView(genes.data(), 2)) == lowest &&
+          evaluator.evaluate(GenomeView(genes.data(), 5)) == lowest && fitnesses[0] == lowest,
+          "genomes that are not at least two x, y pairs get the lowest fitness");
+
+    // Batches too small for the product go through the single-genome kernels.
+    evaluator.evaluate(GenomeMatrixView(genes.data(), 2, 12, 12), fitnesses);
+    check(fitnesses[0] == evaluator.evaluate(GenomeView(genes.data(), 12)) &&
+          fitnesses[1] == evaluator.evaluate(GenomeView(genes.data() + 12, 12)),
+          "small batches score exactly like single genomes");
+
+    // Forward differencing drifts from the basis tables the most at degree 16.
+    genes = genomes(16);
+    std::vector<double> batch(rows);
+    evaluator.evaluate(GenomeMatrixView(genes.data(), rows, 34, 34), batch.data());
+    double drift = 0;
+    for (unsigned int i = 0; i < rows; i++) {
+        drift = std::max(drift, std::abs(batch[i] - evaluator.evaluate(GenomeView(genes.data() + i * 34, 34))));
+    }
+    // About 6e-8 over these paths; the bound leaves room for other compilers.
+    check(drift < 2e-7, "whole batches score like single genomes to 2e-7");
+}
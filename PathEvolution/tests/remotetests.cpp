@@ -0,0 +1,120 @@
+#include "tests.h"
+#include "differentialevolver.h"
+#include "remoteevaluation.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+    const unsigned int popSize = 50;
+    const unsigned int generations = 50;
+
+    void shiftedSphere(double shift, GenomeMatrixView genomes, double* fitnesses)
+    {
+        for (unsigned int row = 0; row < genomes.rows(); row++) {
+            const double* genes = genomes.rowData(row);
+            double sum = 0;
+            for (unsigned int i = 0; i < genomes.row(row).size(); i++) {
+                sum -= (genes[i] - shift) * (genes[i] - shift);
+            }
+            fitnesses[row] = sum;
+        }
+    }
+
+    // The scenario is just the shift of the sphere.
+    BatchObjectiveFunction setup(sf::Packet& scenario)
+    {
+        double shift = 0;
+        if (!(scenario >> shift)) {
+            return BatchObjectiveFunction();
+        }
+
+        return [shift](GenomeMatrixView genomes, double* fitnesses) {
+            shiftedSphere(shift, genomes, fitnesses);
+        };
+    }
+
+    // Waits for the worker's answer, so that a worker which neither answers
+    // nor hangs up fails the test rather than stalling it.
+    sf::Socket::Status answer(sf::TcpSocket& master, sf::Packet& packet)
+    {
+        sf::SocketSelector selector;
+        selector.add(master);
+        if (!selector.wait(sf::seconds(10))) {
+            return sf::Socket::NotReady;
+        }
+        return master.receive(packet);
+    }
+
+    void start(DifferentialEvolver& evolver)
+    {
+        evolver.setSeed(20);
+        evolver.initialize(popSize, 10, -1, 1);
+    }
+}
+
+void testRemoteEvaluation()
+{
+    // Serves masters on its own thread until the test program exits.
+    static EvaluationWorker worker(setup);
+    unsigned short port = 45120;
+    while (!worker.listen(port) && port < 45140) {
+        port++;
+    }
+    worker.setAllowedMaster(sf::IpAddress::LocalHost);
+    std::thread(&EvaluationWorker::run, &worker).detach();
+
+    RemoteEvaluator remote;
+    sf::Packet scenario;
+    scenario << 0.25;
+    remote.setScenario(scenario);
+    if (!check(remote.connect("127.0.0.1", port), "the master reaches the worker over loopback")) {
+        return;
+    }
+
+    // Sequential evaluation hands every generation over in a single call.
+    unsigned int calls = 0;
+    unsigned int smallestCall = popSize;
+    DifferentialEvolver distributed(0.9, 0.5);
+    distributed.setBatchObjectiveFunction([&](GenomeMatrixView trials, double* fitnesses) {
+        calls++;
+        smallestCall = std::min(smallestCall, trials.rows());
+        remote.evaluate(trials, fitnesses);
+    });
+    start(distributed);
+
+    DifferentialEvolver local(0.9, 0.5);
+    local.setBatchObjectiveFunction([](GenomeMatrixView trials, double* fitnesses) {
+        shiftedSphere(0.25, trials, fitnesses);
+    });
+    start(local);
+
+    for (unsigned int i = 0; i < generations; i++) {
+        distributed.improve();
+        local.improve();
+    }
+
+    check(calls == generations && smallestCall == popSize, "every call carries a whole generation");
+    check(remote.getRemoteEvaluations() == distributed.getEvaluations() && remote.getLocalEvaluations() == 0,
+          "all evaluations run on the worker");
+    check(distributed.getBestFitness() == local.getBestFitness(), "the run matches a local one bit for bit");
+    remote.disconnect();
+
+    // The worker serves one master at a time; each of these gets it in turn.
+    RemoteEvaluator rejected;
+    sf::Packet unreadable;
+    unreadable << sf::Uint8(1);
+    rejected.setScenario(unreadable);
+    check(!rejected.connect("127.0.0.1", port), "a scenario the worker cannot read is rejected");
+
+    sf::TcpSocket master;
+    sf::Packet packet;
+    packet << sf::Uint8(1) << sf::Uint32(1) << 0.25;
+    check(master.connect("127.0.0.1", port) == sf::Socket::Done && master.send(packet) == sf::Socket::Done &&
+          answer(master, packet) == sf::Socket::Done, "a hand-made master gets a scenario accepted");
+
+    // 2^32 - 1 rows of 65535 genes, and none of them in the packet.
+    sf::Packet batch;
+    batch << sf::Uint8(3) << sf::Uint32(1) << sf::Uint32(0xFFFFFFFF) << sf::Uint32(0xFFFF);
+    master.send(batch);
+    check(answer(master, packet) == sf::Socket::Disconnected, "an oversized batch header closes the connection");
+}
@@ -0,0 +1,71 @@
+#include "tests.h"
+#include "differentialevolver.h"
+#include <string>
+
+namespace {
+    const unsigned int popSize = 30;
+    const unsigned int dimensionality = 10;
+    const double target = -1e-8;
+    const unsigned int maximumGenerations = 3000;
+
+    ObjectiveFunction shiftedSphere(double centre)
+    {
+        return [centre](GenomeView genome) {
+            const double* genes = genome.data();
+            double sum = 0;
+            for (unsigned int i = 0; i < genome.size(); i++) {
+                sum -= (genes[i] - centre) * (genes[i] - centre);
+            }
+            return sum;
+        };
+    }
+
+    // Generations until the best individual reaches target.
+    unsigned int converge(DifferentialEvolver& evolver)
+    {
+        unsigned int generations = 0;
+        while (generations < maximumGenerations && (generations == 0 || evolver.getBestFitness() < target)) {
+            evolver.improve();
+            generations++;
+        }
+        return generations;
+    }
+
+    // Solves the sphere around 1, then moves it to 2 and re-plans.
+    unsigned int replanned(DifferentialEvolver::GenomeTransform transform)
+    {
+        DifferentialEvolver evolver(0.9, 0.5);
+        evolver.setSeed(17);
+        evolver.setObjectiveFunction(shiftedSphere(1));
+        evolver.initialize(popSize, dimensionality, -5, 5);
+        converge(evolver);
+
+        evolver.setObjectiveFunction(shiftedSphere(2));
+        evolver.replan({}, {}, 0.6, transform);
+        return converge(evolver);
+    }
+}
+
+void testWarmStartReplanning()
+{
+    DifferentialEvolver scratch(0.9, 0.5);
+    scratch.setSeed(17);
+    scratch.setObjectiveFunction(shiftedSphere(2));
+    scratch.initialize(popSize, dimensionality, -5, 5);
+    unsigned int fromScratch = converge(scratch);
+
+    unsigned int untransformed = replanned(DifferentialEvolver::GenomeTransform());
+    unsigned int transformed = replanned([](double* genes, unsigned int count) {
+        for (unsigned int i = 0; i < count; i++) {
+            genes[i] += 1;
+        }
+    });
+
+    std::string generations = " (" + std::to_string(transformed) + ", " + std::to_string(untransformed) + " and " +
+                              std::to_string(fromScratch) + " generations)";
+    check(fromScratch < maximumGenerations, "a run from scratch converges" + generations);
+    // The retained seeds are evaluated before the first generation, so an
+    // exact seed is never replaced by a worse trial.
+    check(transformed == 1, "exactly mapped seeds are already converged" + generations);
+    check(untransformed < fromScratch, "unmapped seeds still beat starting from scratch" + generations);
+}
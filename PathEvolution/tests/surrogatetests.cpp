@@ -0,0 +1,54 @@
+#include "tests.h"
+#include "differentialevolver.h"
+#include <cmath>
+
+namespace {
+    const unsigned int popSize = 40;
+    const unsigned int dimensionality = 10;
+    const unsigned int generations = 400;
+
+    double rastrigin(GenomeView genome)
+    {
+        const double* genes = genome.data();
+        double sum = 10.0 * genome.size();
+        for (unsigned int i = 0; i < genome.size(); i++) {
+            sum += genes[i] * genes[i] - 10 * std::cos(2 * 3.141592653589793 * genes[i]);
+        }
+        return -sum;
+    }
+
+    void start(DifferentialEvolver& evolver)
+    {
+        evolver.setObjectiveFunction(rastrigin);
+        evolver.setParameterControl(ParameterControl::Mode::SHADE);
+        evolver.setSeed(13);
+        evolver.setSurrogate(400, 8, 0.1);
+        evolver.initialize(popSize, dimensionality, -5.12, 5.12);
+    }
+}
+
+void testSurrogateScreening()
+{
+    DifferentialEvolver screened(0.5, 0.5);
+    start(screened);
+    for (unsigned int i = 0; i < generations; i++) {
+        screened.improve();
+    }
+
+    const SurrogateStatistics& statistics = screened.getSurrogateStatistics();
+    unsigned long trials = static_cast<unsigned long>(popSize) * generations;
+    check(statistics.skipped > trials / 2, "the surrogate skips most trials");
+    // The initial individuals are not evaluated; the first trials replace them.
+    check(screened.getEvaluations() + statistics.skipped == trials, "every trial is either evaluated or skipped");
+    check(statistics.audited > 0, "a share of the rejected trials is audited");
+    check(statistics.wrongRejections * 4 < statistics.audited, "at least three in four rejections are right");
+
+    // Screening draws from seeded streams, so a run replays exactly.
+    DifferentialEvolver replay(0.5, 0.5);
+    start(replay);
+    for (unsigned int i = 0; i < generations; i++) {
+        replay.improve();
+    }
+    check(replay.getBestFitness() == screened.getBestFitness() &&
+          replay.getSurrogateStatistics().skipped == statistics.skipped, "a screened run replays for its seed");
+}
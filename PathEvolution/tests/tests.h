@@ -0,0 +1,32 @@
+#ifndef TESTS_H
+#define TESTS_H
+
+#include <string>
+
+// Prints what unless condition holds and remembers the failure for the exit
+// status. Returns condition.
+bool check(bool condition, const std::string& what);
+
+// evolveAsynchronously(): evaluation counts, progress over several calls and
+// statistics taken from the live population.
+void testAsynchronousEvolution();
+// Surrogate pre-screening: trials skipped and audited, how often rejections
+// are right, and reproducibility.
+void testSurrogateScreening();
+// replan(): warm-started runs against one from scratch.
+void testWarmStartReplanning();
+// CMA-ES against SHADE on the sphere and Rosenbrock, and termination
+// through the Optimizer interface.
+void testCovarianceMatrixAdaptation();
+// Memetic Nelder-Mead refinement: evaluation counting, budgets and the
+// fitness cache.
+void testLocalSearch();
+// Distributed evaluation over loopback: batching, results and the worker's
+// checks of what masters send.
+void testRemoteEvaluation();
+// Scenario packets, malformed genomes and batch against single-genome scoring.
+void testPathEvaluator();
+// The degree-specialized Bezier kernels against the basis tables.
+void testBezierKernels();
+
+#endif // TESTS_H
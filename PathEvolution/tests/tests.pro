@@ -0,0 +1,48 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = tests
+INCLUDEPATH += ..
+
+win32 {
+    INCLUDEPATH += "$$PWD/../LabSFML/include"
+    LIBS += -L"$$PWD/../LabSFML/lib"
+}
+
+LIBS += -lsfml-graphics -lsfml-window -lsfml-network -lsfml-system -lpthread
+
+SOURCES += main.cpp \
+    asynctests.cpp \
+    surrogatetests.cpp \
+    replantests.cpp \
+    cmaestests.cpp \
+    localsearchtests.cpp \
+    remotetests.cpp \
+    pathevaluatortests.cpp \
+    beziertests.cpp \
+    ../differentialevolver.cpp \
+    ../threadpool.cpp \
+    ../population.cpp \
+    ../strategy.cpp \
+    ../parametercontrol.cpp \
+    ../random.cpp \
+    ../statistics.cpp \
+    ../fitnesscache.cpp \
+    ../surrogate.cpp \
+    ../termination.cpp \
+    ../checkpoint.cpp \
+    ../localsearch.cpp \
+    ../cmaes.cpp \
+    ../remoteevaluation.cpp \
+    ../pathevaluator.cpp \
+    ../util.cpp \
+    ../bezierbasis.cpp \
+    ../bezierkernel.cpp \
+    ../curvebatch.cpp
+
+HEADERS += \
+    tests.h
+
+QMAKE_CXXFLAGS += -O2 -pthread
@@ -0,0 +1,166 @@
+#include "threadpool.h"
+#include <algorithm>
+
+namespace {
+    std::uint64_t packRange(std::uint32_t begin, std::uint32_t end)
+    {
+        return (static_cast<std::uint64_t>(begin) << 32) | end;
+    }
+
+    std::uint32_t rangeBegin(std::uint64_t range)
+    {
+        return static_cast<std::uint32_t>(range >> 32);
+    }
+
+    std::uint32_t rangeEnd(std::uint64_t range)
+    {
+        return static_cast<std::uint32_t>(range);
+    }
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : threadCount(threadCount)
+{
+    if (this->threadCount == 0) {
+        this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    ranges.reset(new WorkRange[this->threadCount]);
+    for (unsigned int i = 0; i < this->threadCount; i++) {
+        ranges[i].range.store(0);
+    }
+
+    for (unsigned int i = 1; i < this->threadCount; i++) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startCondition.notify_all();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+    return threadCount;
+}
+
+void ThreadPool::parallelFor(unsigned int count, const std::function<void(unsigned int)>& task)
+{
+    if (count == 0) {
+        return;
+    }
+
+    if (threadCount == 1 || count == 1) {
+        for (unsigned int i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    unsigned int chunk = count / threadCount;
+    unsigned int remainder = count % threadCount;
+    unsigned int begin = 0;
+    for (unsigned int i = 0; i < threadCount; i++) {
+        unsigned int end = begin + chunk + (i < remainder ? 1 : 0);
+        ranges[i].range.store(packRange(begin, end));
+        begin = end;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        pending = threadCount - 1;
+        batch++;
+    }
+    startCondition.notify_all();
+
+    runTasks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this]() { return pending == 0; });
+    this->task = nullptr;
+}
+
+void ThreadPool::workerLoop(unsigned int worker)
+{
+    std::uint64_t seenBatch = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startCondition.wait(lock, [&]() { return stopping || batch != seenBatch; });
+            if (stopping) {
+                return;
+            }
+            seenBatch = batch;
+        }
+
+        runTasks(worker);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = --pending == 0;
+        }
+        if (last) {
+            doneCondition.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runTasks(unsigned int worker)
+{
+    unsigned int index;
+    while (popLocal(worker, index) || steal(worker, index)) {
+        (*task)(index);
+    }
+}
+
+bool ThreadPool::popLocal(unsigned int worker, unsigned int& index)
+{
+    std::atomic<std::uint64_t>& own = ranges[worker].range;
+    std::uint64_t current = own.load();
+
+    while (rangeBegin(current) < rangeEnd(current)) {
+        std::uint64_t next = packRange(rangeBegin(current) + 1, rangeEnd(current));
+        if (own.compare_exchange_weak(current, next)) {
+            index = rangeBegin(current);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::steal(unsigned int worker, unsigned int& index)
+{
+    for (unsigned int offset = 1; offset < threadCount; offset++) {
+        std::atomic<std::uint64_t>& victim = ranges[(worker + offset) % threadCount].range;
+        std::uint64_t current = victim.load();
+
+        while (rangeBegin(current) < rangeEnd(current)) {
+            std::uint32_t begin = rangeBegin(current);
+            std::uint32_t end = rangeEnd(current);
+            std::uint32_t stolen = std::max(1u, (end - begin) / 2);
+
+            if (victim.compare_exchange_weak(current, packRange(begin, end - stolen))) {
+                // Our own slot is empty at this point, so only thieves can race
+                // with this store, and their CAS fails on the changed value.
+                index = end - stolen;
+                ranges[worker].range.store(packRange(index + 1, end));
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
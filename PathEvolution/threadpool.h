@@ -0,0 +1,57 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool that runs index-parallel loops. Each worker starts with a
+// contiguous slice of the index range and steals half of a busy worker's
+// remaining slice once its own runs dry, so uneven task costs still keep
+// every core busy. The calling thread takes part as worker 0.
+class ThreadPool
+{
+private:
+    struct WorkRange {
+        // Begin index in the upper 32 bits, end index in the lower 32 bits.
+        std::atomic<std::uint64_t> range;
+        char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+    };
+
+    std::vector<std::thread> threads;
+    std::unique_ptr<WorkRange[]> ranges;
+    unsigned int threadCount;
+
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+    const std::function<void(unsigned int)>* task = nullptr;
+    std::uint64_t batch = 0;
+    unsigned int pending = 0;
+    bool stopping = false;
+
+    void workerLoop(unsigned int worker);
+    void runTasks(unsigned int worker);
+    bool popLocal(unsigned int worker, unsigned int& index);
+    bool steal(unsigned int worker, unsigned int& index);
+
+public:
+    // A thread count of zero sizes the pool from std::thread::hardware_concurrency().
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int getThreadCount() const;
+
+    // Calls task(i) for every i in [0, count) and returns once all calls are done.
+    void parallelFor(unsigned int count, const std::function<void(unsigned int)>& task);
+};
+
+#endif // THREADPOOL_H
@@ -1,14 +1,12 @@
 #include "util.h"
 #include <cmath>
-#include <random>
-#include <ctime>
-#include <thread>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 
 sf::Font* Util::font = nullptr;
-Util::BezierMemo Util::bezierMemo = Util::BezierMemo();
 
 sf::Texture Util::loadTexture(const std::string& file)
 {
@@ -121,52 +119,53 @@ double Util::toDegrees(double radians) {
     return (radians / pi()) * 180;
 }
 
-Point2D Util::bezierCurve(double t, const std::vector<Point2D> points)
-{
-    int n = points.size() - 1;
-    Point2D point(0, 0);
-
-    for (int i = 0; i <= n; i++) {
-        double c;
-        if (bezierMemo.find(i) != bezierMemo.end()) {
-            if (bezierMemo[i].find(t) != bezierMemo[i].end()) {
-                c = bezierMemo[i][t];
-            } else {
-                c = binomialCoefficient(n, i) * std::pow(1 - t, n - i) * std::pow(t, i);
-                bezierMemo[i][t] = c;
-            }
-        } else {
-            c = binomialCoefficient(n, i) * std::pow(1 - t, n - i) * std::pow(t, i);
-            bezierMemo[i] = std::unordered_map<double, double>();
-            bezierMemo[i][t] = c;
+namespace {
+    std::atomic<std::uint64_t> masterSeed(Random::DefaultSeed);
+    std::atomic<unsigned int> seedEpoch(0);
+    std::atomic<unsigned int> threadCount(0);
+
+    // One generator per thread, derived from the master seed and the order in
+    // which threads first asked for random numbers; reseeded after Util::setSeed().
+    Random& threadGenerator()
+    {
+        static thread_local unsigned int ordinal = threadCount++;
+        static thread_local unsigned int epoch = seedEpoch.load();
+        static thread_local Random generator = Random::stream(masterSeed.load(), ordinal);
+
+        if (epoch != seedEpoch.load()) {
+            epoch = seedEpoch.load();
+            generator = Random::stream(masterSeed.load(), ordinal);
         }
 
-        point.first += points[i].first * c;
-        point.second += points[i].second * c;
+        return generator;
     }
 
-    return point;
+    std::vector<unsigned int> drawDistinct(unsigned int count, unsigned int min, unsigned int max)
+    {
+        std::vector<unsigned int> elements(count);
+        threadGenerator().sampleDistinct(max - min + 1, count, nullptr, 0, elements.data());
+        for (unsigned int& element : elements) {
+            element += min;
+        }
+
+        return elements;
+    }
 }
 
-std::vector<Point2D> Util::toPoints2D(const std::vector<double> &values)
+void Util::setSeed(std::uint64_t seed)
 {
-    std::vector<Point2D> points;
-
-    for (unsigned int i = 0; i < values.size(); i += 2) {
-        points.push_back({values[i], values[i + 1]});
-    }
+    masterSeed = seed;
+    seedEpoch++;
+}
 
-    return points;
+Random& Util::generator()
+{
+    return threadGenerator();
 }
 
 double Util::random(double min, double max)
 {
-    static std::mt19937* generator = nullptr;
-    if (!generator) generator = new std::mt19937(/*std::clock() + std::hash<std::thread::id>()(std::this_thread::get_id())*/);
-
-    std::uniform_real_distribution<double> distribution(min, max);
-
-    return distribution(*generator);
+    return threadGenerator().uniform(min, max);
 }
 
 int Util::irandom(double min, double max)
@@ -181,10 +180,7 @@ double Util::pi(double multiplier, double denominator)
 
 double Util::saferandom(double min, double max)
 {
-    static thread_local std::mt19937* generator = nullptr;
-    if (!generator) generator = new std::mt19937(std::clock() + std::hash<std::thread::id>()(std::this_thread::get_id()));
-    std::uniform_real_distribution<double> distribution(min, max);
-    return distribution(*generator);
+    return random(min, max);
 }
 
 int Util::safeirandom(double min, double max)
@@ -192,50 +188,34 @@ int Util::safeirandom(double min, double max)
     return std::round(saferandom(min, max));
 }
 
+void Util::sampleDistinct(unsigned int max, unsigned int quantity, std::initializer_list<unsigned int> excluded, unsigned int* out)
+{
+    threadGenerator().sampleDistinct(max, quantity, excluded, out);
+}
+
 std::set<unsigned int> Util::chooseRandomlyOrdered(unsigned int count, unsigned int min, unsigned int max)
 {
-    std::set<unsigned int> elements;
-    while (elements.size() < count) {
-        elements.insert(Util::irandom(min, max));
-    }
+    std::vector<unsigned int> elements = drawDistinct(count, min, max);
 
-    return elements;
+    return std::set<unsigned int>(elements.begin(), elements.end());
 }
 
 std::unordered_set<unsigned int> Util::chooseRandomly(unsigned int count, unsigned int min, unsigned int max)
 {
-    std::unordered_set<unsigned int> elements;
-    while (elements.size() < count) {
-        elements.insert(Util::irandom(min, max));
-    }
+    std::vector<unsigned int> elements = drawDistinct(count, min, max);
 
-    return elements;
+    return std::unordered_set<unsigned int>(elements.begin(), elements.end());
 }
 
 std::unordered_set<unsigned int> Util::safeChooseRandomly(unsigned int count, unsigned int min, unsigned int max)
 {
-    std::unordered_set<unsigned int> elements;
-    while (elements.size() < count) {
-        elements.insert(Util::safeirandom(min, max));
-    }
-
-    return elements;
+    return chooseRandomly(count, min, max);
 }
 
-std::unordered_set<unsigned> Util::chooseRandomlyRestricted(unsigned max, unsigned quantity, std::unordered_set<unsigned> restricted) {
-    std::unordered_set<unsigned> values;
-    std::unordered_set<unsigned>::iterator nav;
-    std::unordered_set<unsigned>::iterator restrictedNav;
-
-    while (values.size() != quantity){
-        unsigned element = irandom(0, max - 1); //Tamanho máximo (exclusivo)
-        nav = values.find(element);
-        restrictedNav = restricted.find(element);
-
-        if (nav == values.end() && restrictedNav == restricted.end()) { //Se não está presente em nenhum dos conjuntos
-            values.insert(element);
-        }
-    }
+std::unordered_set<unsigned> Util::chooseRandomlyRestricted(unsigned max, unsigned quantity, const std::unordered_set<unsigned>& restricted) {
+    std::vector<unsigned> excluded(restricted.begin(), restricted.end());
+    std::vector<unsigned> values(quantity);
+    threadGenerator().sampleDistinct(max, quantity, excluded.data(), excluded.size(), values.data());
 
-    return values;
+    return std::unordered_set<unsigned>(values.begin(), values.end());
 }
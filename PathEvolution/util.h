@@ -6,16 +6,16 @@
 #include <set>
 #include <unordered_set>
 #include <unordered_map>
+#include <initializer_list>
 #include <SFML/Graphics.hpp>
+#include "random.h"
 
 using Point2D = std::pair<double, double>;
 
 class Util
 {
 private:
-    using BezierMemo = std::unordered_map<int, std::unordered_map<double, double>>;
     static sf::Font* font;
-    static BezierMemo bezierMemo;
 
 public:
     template <class T, class U>
@@ -32,19 +32,25 @@ public:
     static sf::Font* getFont();
     static double factorial(double n);
     static double binomialCoefficient(unsigned int n, unsigned int k);
-    static Point2D bezierCurve(double t, const std::vector<Point2D> points);
-    static std::vector<Point2D> toPoints2D(const std::vector<double>& values);
 
+    // Random numbers come from a per-thread xoshiro256** stream derived from the
+    // master seed, so they are thread-safe and single-threaded runs replay exactly.
+    static void setSeed(std::uint64_t seed);
+    static Random& generator();
     static double random(double min = 0, double max = 1);
     static int irandom(double min = 0, double max = 1);
     static double pi(double multiplier = 1, double denominator = 1);
 
+    // Kept for existing callers; random() is thread-safe as well now.
     static double saferandom(double min = 0, double max = 1);
     static int safeirandom(double min = 0, double max = 1);
     static std::unordered_set<unsigned int> chooseRandomly(unsigned int count, unsigned int min, unsigned int max);
     static std::unordered_set<unsigned int> safeChooseRandomly(unsigned int count, unsigned int min, unsigned int max);
     static std::set<unsigned int> chooseRandomlyOrdered(unsigned int count, unsigned int min, unsigned int max);
-    static std::unordered_set<unsigned> chooseRandomlyRestricted(unsigned max, unsigned quantity, std::unordered_set<unsigned> restricted);
+    static std::unordered_set<unsigned> chooseRandomlyRestricted(unsigned max, unsigned quantity, const std::unordered_set<unsigned>& restricted);
+    // Writes quantity distinct values from [0, max) that are not in excluded
+    // to out, without allocating. Meant for small quantities, as in DE donor picking.
+    static void sampleDistinct(unsigned int max, unsigned int quantity, std::initializer_list<unsigned int> excluded, unsigned int* out);
     static double toDegrees(double radians);
     static float calculateFontMiddle(const sf::Font* font, unsigned int characterSize);
     static std::string readEntireFile(const std::string& path);
@@ -13,7 +13,8 @@ Window::Window(int width, int height) :
     sf::RenderWindow(sf::VideoMode(width, height), L"Evolução de Caminhos", sf::Style::Default, sf::ContextSettings(0, 0, 8)),
     stageSize(width - paneWidth, height),
     pane(sf::Vector2f(paneWidth, height)),
-    distanceSelector(2)
+    distanceSelector(2),
+    evolver(0.75, 0.06)
 {
     setFramerateLimit(60);
     arrays.push_back(sf::VertexArray(sf::LinesStrip));
@@ -90,6 +91,20 @@ Window::Window(int width, int height) :
     shader.loadFromMemory(Util::readEntireFile("light.frag"), sf::Shader::Fragment);
     shader.setUniform("texture", sf::Shader::CurrentTexture);
     shader.setUniform("resolution", stageSize);
+
+    evolver.setParameterControl(ParameterControl::Mode::SHADE);
+    evolver.setFitnessCache(4096, 1e-4);
+
+    TerminationCriteria criteria;
+    criteria.stagnationGenerations = 300;
+    criteria.stagnationEpsilon = 1e-6;
+    criteria.minimumDiversity = 1e-4;
+    evolver.setTermination(criteria);
+}
+
+bool Window::connectWorker(const std::string& host, unsigned short port)
+{
+    return remote.connect(host, port);
 }
 
 void Window::drawBorder(sf::RenderTexture& texture)
@@ -210,6 +225,53 @@ bool Window::isInStage(const sf::Vector2f& point) {
     return point.x < stageSize.x;
 }
 
+void Window::adaptGenes(double* genes, unsigned int count) const
+{
+    // Rotates and scales the old paths about the start so that the old
+    // start-destination segment lands on the new one.
+    sf::Vector2f from = plannedDestination - plannedStart;
+    sf::Vector2f to = destination.getPosition() - start.getPosition();
+    float fromLength = std::hypot(from.x, from.y);
+    float toLength = std::hypot(to.x, to.y);
+
+    float scale = 1;
+    float angle = 0;
+    if (fromLength > 0 && toLength > 0) {
+        scale = toLength / fromLength;
+        angle = std::atan2(to.y, to.x) - std::atan2(from.y, from.x);
+    }
+    float cosine = std::cos(angle) * scale;
+    float sine = std::sin(angle) * scale;
+
+    sf::Vector2u imageSize = scenarioImage.getSize();
+    auto blocked = [&](const sf::Vector2f& point) {
+        return point.x >= 0 && point.y >= 0 && point.x + 1 < imageSize.x && point.y + 1 < imageSize.y &&
+               !isEmpty(scenarioImage, sf::FloatRect(point.x, point.y, 0, 0));
+    };
+
+    for (unsigned int i = 0; i + 1 < count; i += 2) {
+        sf::Vector2f relative(genes[i] * stageSize.x - plannedStart.x, genes[i + 1] * stageSize.y - plannedStart.y);
+        sf::Vector2f point = start.getPosition() + sf::Vector2f(cosine * relative.x - sine * relative.y,
+                                                                sine * relative.x + cosine * relative.y);
+
+        // Control points that ended up inside an obstacle are moved to the
+        // closest free spot found on a few rings around them.
+        for (float radius = 10; blocked(point) && radius <= 100; radius += 10) {
+            for (int k = 0; k < 8; k++) {
+                float direction = Util::pi(k, 4);
+                sf::Vector2f candidate = point + radius * sf::Vector2f(std::cos(direction), std::sin(direction));
+                if (!blocked(candidate)) {
+                    point = candidate;
+                    break;
+                }
+            }
+        }
+
+        genes[i] = std::max(-0.5f, std::min(1.5f, point.x / stageSize.x));
+        genes[i + 1] = std::max(-0.5f, std::min(1.5f, point.y / stageSize.y));
+    }
+}
+
 bool Window::isEmpty(const sf::Image& image, sf::FloatRect rect) const {
     for (unsigned int x = rect.left; x <= std::ceil(rect.left + rect.width); x++) {
         for (unsigned int y = rect.top; y <= std::ceil(rect.top + rect.height); y++) {
@@ -262,26 +324,28 @@ std::vector<sf::FloatRect> Window::coverScenario(const sf::Image& image, int len
     return rectangles;
 }
 
-sf::VertexArray Window::constructBezierCurve(const std::vector<Point2D>& points, double step, sf::Color color)
+sf::VertexArray Window::constructBezierCurve(GenomeView genome, double step, sf::Color color)
 {
     sf::VertexArray va(sf::PrimitiveType::LinesStrip);
 
+    unsigned int samples = std::round(1 / step) + 1;
+    std::shared_ptr<const BezierBasis> basis = BezierBasis::uniform(genome.size() / 2 - 1, samples);
+    std::vector<double> xs(samples);
+    std::vector<double> ys(samples);
+    basis->sample(genome, xs.data(), ys.data());
+
     sf::Vector2f oldPos;
-    for (double t = 0; t < (1 + step); t += step) {
-        Point2D point = Util::bezierCurve(t, points);
-        sf::Vector2f pos(point.first * stageSize.x, point.second * stageSize.y);
+    for (unsigned int i = 0; i < samples; i++) {
+        sf::Vector2f pos(xs[i] * stageSize.x, ys[i] * stageSize.y);
         sf::Vertex vertex(pos, color);
 
         va.append(vertex);
 
-        if (t > 0) {
+        if (i > 0) {
             sf::Vector2f delta = pos - oldPos;
             float angle = std::atan2(delta.y, delta.x);
 
-            carSprite.setPosition(pos);
-            carSprite.setRotation(Util::toDegrees(angle) - 90);
-
-            if (carCollides() && stopSelector.isRightActive()) {
+            if (pathEvaluator->collides(pos, Util::toDegrees(angle) - 90) && stopSelector.isRightActive()) {
                 break;
             }
         }
@@ -308,10 +372,8 @@ int Window::calculateNextPosition(int k, float speed, const sf::VertexArray& va)
     return nextK;
 }
 
-void Window::updateTrajectories(const DifferentialEvolver& evolver, const sf::Sprite& scenario, std::deque<Trajectory>& trajectories, sf::RenderTexture& offscreenStage)
+void Window::updateTrajectories(const PopulationSnapshot& population, const sf::Sprite& scenario, std::deque<Trajectory>& trajectories, sf::RenderTexture& offscreenStage)
 {
-    const std::vector<DifferentialEvolver::Individual>& originalPopulation = evolver.getPopulation();
-
     int limit = 5;
 
     for (Trajectory& trajectory : trajectories) {
@@ -322,10 +384,9 @@ void Window::updateTrajectories(const DifferentialEvolver& evolver, const sf::Sp
         trajectories.pop_front();
     }
 
-    for (unsigned int i = 0; i < originalPopulation.size(); i++) {
-        std::vector<Point2D> points = Util::toPoints2D(originalPopulation[i]);
-        sf::VertexArray va = constructBezierCurve(points, 0.005, sf::Color(255, 0, 0, 255));
-        trajectories.emplace_back(va, evolver.getFitness(i), limit);
+    for (unsigned int i = 0; i < population.size(); i++) {
+        sf::VertexArray va = constructBezierCurve(population[i], 0.005, sf::Color(255, 0, 0, 255));
+        trajectories.emplace_back(va, population.getFitness(i), limit);
     }
 
     auto minmax = std::minmax_element(trajectories.begin(), trajectories.end(), [&](const Trajectory& a, const Trajectory& b) {
@@ -335,34 +396,27 @@ void Window::updateTrajectories(const DifferentialEvolver& evolver, const sf::Sp
     double minFitness = minmax.first->fitness;
     double maxFitness = minmax.second->fitness;
 
-    {
-        std::lock_guard<std::mutex> lock(mutex);
-        setActive(true);
-        offscreenStage.clear(sf::Color::Transparent);
-        offscreenStage.draw(scenario);
-
-        for (Trajectory& trajectory : trajectories) {
-            double normalized = (trajectory.fitness - minFitness) / (maxFitness - minFitness);
+    offscreenStage.clear(sf::Color::Transparent);
+    offscreenStage.draw(scenario);
 
-            if (minFitness == maxFitness) {
-                normalized = 1;
-            }
+    for (Trajectory& trajectory : trajectories) {
+        double normalized = (trajectory.fitness - minFitness) / (maxFitness - minFitness);
 
-            sf::VertexArray& va = trajectory.va;
-            for (int i = 0; i < va.getVertexCount(); i++) {
-                double scale = trajectory.remainingTime / static_cast<double>(limit);
-                scale = std::max(0.0, scale);
-                va[i].color = Util::fromHSV(normalized * 300 - 180, 1, 1);
-                va[i].color.a = std::round(normalized * scale * 255);
-            }
+        if (minFitness == maxFitness) {
+            normalized = 1;
+        }
 
-            offscreenStage.draw(va);
+        sf::VertexArray& va = trajectory.va;
+        for (int i = 0; i < va.getVertexCount(); i++) {
+            double scale = trajectory.remainingTime / static_cast<double>(limit);
+            scale = std::max(0.0, scale);
+            va[i].color = Util::fromHSV(normalized * 300 - 180, 1, 1);
+            va[i].color.a = std::round(normalized * scale * 255);
         }
-        offscreenStage.display();
-        draw(sf::Sprite(offscreenStage.getTexture()));
-        setActive(false);
-        dataAvailable = true;
+
+        offscreenStage.draw(va);
     }
+    offscreenStage.display();
 
 //    sf::RenderTexture buffer1;
 //    sf::RenderTexture buffer2;
@@ -486,88 +540,50 @@ bool Window::loop()
         destination.getPosition().y / stageSize.y
     };
 
-    DifferentialEvolver evolver(0.75, 0.06);
-    evolver.initialize(50, 30, -0.5, 1.5,
-        {start.getPosition().x / stageSize.x, start.getPosition().y / stageSize.y},
-        (automaticDestinationSelector.isLeftActive() ? std::vector<double>() : suffix)
-    );
-
-    sf::Texture carTex;
-    carTex.loadFromFile("car.png");
-
-    sf::Texture whiteTex = colorizeTexture(carTex, sf::Color::White);
-
-    carSprite.setTexture(whiteTex);
-    Util::centralizeOrigin(carSprite, carTex.getSize());
-    carSprite.setScale(0.2, 0.2);
+    std::vector<double> prefix{start.getPosition().x / stageSize.x, start.getPosition().y / stageSize.y};
+    std::vector<double> fixedSuffix = automaticDestinationSelector.isLeftActive() ? std::vector<double>() : suffix;
 
-    evolver.setObjectiveFunction([&](const DifferentialEvolver::Individual& ind) {
-        carSprite.setTexture(carTex);
-        std::vector<Point2D> points = Util::toPoints2D(ind);
-
-        double collisions = 0;
-
-        sf::Vector2f oldPos;
-        carSprite.setPosition(points[0].first, points[0].second);
-
-        double arcLength = 0;
-        double distanceSum = 0;
-        int steps = 0;
-
-        double interval = 0.005;
-        for (double t = 0; t <= 1; t += interval) {
-            Point2D point = Util::bezierCurve(t, points);
-            sf::Vector2f pos(point.first * stageSize.x, point.second * stageSize.y);
-
-            if (t != 0) {
-                sf::Vector2f delta = pos - oldPos;
-                sf::Vector2f deltaDestination = destination.getPosition() - pos;
-
-                arcLength += std::hypot(delta.x / stageSize.x, delta.y / stageSize.y);
-                distanceSum += std::hypot(deltaDestination.x / stageSize.x, deltaDestination.y / stageSize.y);
-                float angle = std::atan2(delta.y, delta.x);
-
-                carSprite.setPosition(pos);
-                carSprite.setRotation(Util::toDegrees(angle) - 90);
-
-                if (carCollides()) {
-                    collisions++;
-                }
-            }
-
-            steps++;
-            if (collisions > 0 && stopSelector.isRightActive()) {
-                break;
-            }
-
-            oldPos = pos;
-        }
-
-        sf::Vector2f delta = destination.getPosition() - carSprite.getPosition();
-        float finalDistance = std::hypot(delta.x / stageSize.x, delta.y / stageSize.y);
-
-        //IMPORTANT: check weight scaling when collide-stopping
-        collisions = collisions * collisionSelector.getWeight();
-        finalDistance = finalDistance * distanceSelector.getWeight();
-        arcLength = arcLength * arcLengthSelector.getWeight();
-        distanceSum = distanceSum * arcLengthSelector.getWeight();
-
-        carSprite.setTexture(carTex);
-        if (collisionSelector.isLeftActive()) {
-            collisions *= -1;
-        }
+    if (planned) {
+        evolver.replan(prefix, fixedSuffix, 0.6, [this](double* genes, unsigned int count) {
+            adaptGenes(genes, count);
+        });
+    } else {
+        evolver.initialize(50, 30, -0.5, 1.5, prefix, fixedSuffix);
+    }
 
-        if (arcLengthSelector.isLeftActive()) {
-            arcLength *= -1;
-        }
+    planned = true;
+    plannedStart = start.getPosition();
+    plannedDestination = destination.getPosition();
 
-        if (distanceSelector.isLeftActive(0)) {
-            finalDistance *= -1;
-            distanceSum *= -1;
-        }
+    sf::Texture carTex;
+    carTex.loadFromFile("car.png");
 
-        return collisions + arcLength + (distanceSelector.isLeftActive(1) ? finalDistance : distanceSum);
-    });
+    PathSettings settings;
+    settings.collisionWeight = collisionSelector.getWeight();
+    settings.distanceWeight = distanceSelector.getWeight();
+    settings.arcLengthWeight = arcLengthSelector.getWeight();
+    settings.minimizeCollisions = collisionSelector.isLeftActive();
+    settings.minimizeDistance = distanceSelector.isLeftActive(0);
+    settings.finalDistanceOnly = distanceSelector.isLeftActive(1);
+    settings.minimizeArcLength = arcLengthSelector.isLeftActive();
+    settings.stopOnCollision = stopSelector.isRightActive();
+
+    sf::Vector2f footprint(carTex.getSize().x * 0.2f, carTex.getSize().y * 0.2f);
+    pathEvaluator = std::make_shared<const PathEvaluator>(scenarioImage, footprint, destination.getPosition(), settings);
+
+    if (remote.getWorkerCount() > 0) {
+        sf::Packet scenarioPacket;
+        pathEvaluator->write(scenarioPacket);
+        remote.setScenario(scenarioPacket);
+        remote.setFallback(PathEvaluator::batchFunction(pathEvaluator));
+        // Without a pool each generation reaches the remote evaluator as one
+        // batch, which it splits across the workers' pipelines.
+        evolver.setParallelEvaluation(false);
+        evolver.setBatchObjectiveFunction(remote.function());
+    } else {
+        evolver.setParallelEvaluation(true);
+        evolver.setBatchObjectiveFunction(PathEvaluator::batchFunction(pathEvaluator));
+    }
 
     trajectories.clear();
     stageBuffer.clear(sf::Color::Transparent);
@@ -576,13 +592,27 @@ bool Window::loop()
     offscreenStage.clear(sf::Color::Transparent);
     offscreenStage.display();
 
+    // Whatever the previous run left in the buffer is not drawn again.
+    unsigned long drawnSequence = 0;
+    if (SnapshotBuffer<PopulationSnapshot>::Snapshot previous = snapshots.read()) {
+        drawnSequence = previous.sequence();
+    }
+
     std::cout << "Starting thread\n";
 
     std::thread evolverThread([&]() {
-        for (generation = 0; running; generation++) {
-            evolver.improve();
+        Optimizer& optimizer = evolver;
+        for (generation = 0; running && !optimizer.isFinished(); generation++) {
+            optimizer.improve();
 
-            updateTrajectories(evolver, scenario, trajectories, offscreenStage);
+            snapshots.publish([&](PopulationSnapshot& snapshot) {
+                snapshot.capture(optimizer);
+            });
+        }
+
+        if (optimizer.isFinished()) {
+            std::cout << "Finished after " << generation << " generations: "
+                      << toString(optimizer.getTerminationReason()) << "\n";
         }
     });
 
@@ -592,8 +622,6 @@ bool Window::loop()
 //    carSprite.setPosition(va[k].position);
 
 
-    dataAvailable = false;
-
     std::cout << "Starting loop\n";
 
     while (isOpen() && running) {
@@ -620,22 +648,21 @@ bool Window::loop()
             }
         }
 
-        std::lock_guard<std::mutex> lock(mutex);
-        setActive(true);
-
-        clear();
-
-        draw(backgroundSprite);
-        draw(sf::Sprite(stageBuffer.getTexture()));
-
-        if (dataAvailable) {
+        SnapshotBuffer<PopulationSnapshot>::Snapshot snapshot = snapshots.read();
+        if (snapshot && snapshot.sequence() != drawnSequence) {
+            drawnSequence = snapshot.sequence();
+            updateTrajectories(*snapshot, scenario, trajectories, offscreenStage);
 
             stageBuffer.clear(sf::Color::Transparent);
             stageBuffer.draw(sf::Sprite(offscreenStage.getTexture()));
             stageBuffer.display();
-            dataAvailable = false;
         }
 
+        clear();
+
+        draw(backgroundSprite);
+        draw(sf::Sprite(stageBuffer.getTexture()));
+
         draw(start);
         draw(destination);
         drawPane();
@@ -672,30 +699,9 @@ bool Window::loop()
 //        }
 
         display();
-        setActive(false);
     }
 }
 
-bool Window::carCollides() const
-{
-    sf::FloatRect stageBuffered(-20, -20, stageSize.x + 40, stageSize.y + 40);
-    sf::FloatRect stage(0, 0, stageSize.x, stageSize.y);
-    if (!stage.contains(carSprite.getPosition()) && stageBuffered.contains(carSprite.getPosition())) {
-        return true;
-    }
-
-    sf::FloatRect bounds = carSprite.getGlobalBounds();
-    for (const sf::FloatRect& rect : obstacles) {
-        sf::FloatRect intersection;
-        if (rect.intersects(bounds, intersection)) {
-            if (!isEmpty(scenarioImage, intersection)) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
 bool Window::checkPixelCollisions(const sf::Image& a, const sf::Image& b, sf::FloatRect bounds)
 {
     for (unsigned int x = bounds.left; x <= std::ceil(bounds.left + bounds.width); x++) {
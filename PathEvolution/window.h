@@ -9,8 +9,12 @@
 #include "weightedbinaryselector.h"
 #include "binaryselector.h"
 #include "button.h"
+#include "snapshotbuffer.h"
+#include "pathevaluator.h"
+#include "bezierbasis.h"
+#include "remoteevaluation.h"
 
-#include <mutex>
+#include <atomic>
 
 struct Trajectory {
     sf::VertexArray va;
@@ -38,8 +42,7 @@ class Window : public sf::RenderWindow
 private:
     using SelectorConfig = std::pair<BinarySelector*, SelectorLabelling>;
 
-    std::mutex mutex;
-    bool running;
+    std::atomic<bool> running;
 
     static const sf::Color paneColor;
     float paneWidth = 350;
@@ -69,7 +72,6 @@ private:
     Button stopButton;
     Button clearButton;
 
-    sf::Sprite carSprite;
     sf::Image scenarioImage;
     std::vector<sf::FloatRect> obstacles;
 
@@ -82,29 +84,42 @@ private:
     std::deque<Trajectory> trajectories;
     sf::RenderTexture offscreenStage;
     sf::RenderTexture stageBuffer;
-    bool dataAvailable = false;
+    // Populations published by the evolver thread for the UI thread to draw.
+    SnapshotBuffer<PopulationSnapshot> snapshots;
 
     sf::Shader shader;
 
     int generation;
 
+    // Kept across runs so that a new run starts from the last one's paths.
+    DifferentialEvolver evolver;
+    // Scenario of the current run, shared by the objective and the renderer.
+    std::shared_ptr<const PathEvaluator> pathEvaluator;
+    RemoteEvaluator remote;
+    bool planned = false;
+    sf::Vector2f plannedStart;
+    sf::Vector2f plannedDestination;
+
     bool checkPixelCollisions(const sf::Image &a, const sf::Image &b, sf::FloatRect bounds);
     bool isEmpty(const sf::Image &image, sf::FloatRect rect) const;
 
     sf::Texture colorizeTexture(const sf::Texture &tex, sf::Color color);
     sf::Texture constructScenario();
     std::vector<sf::FloatRect> coverScenario(const sf::Image &image, int length);
-    sf::VertexArray constructBezierCurve(const std::vector<Point2D> &points, double step, sf::Color color);
+    sf::VertexArray constructBezierCurve(GenomeView genome, double step, sf::Color color);
 
     int calculateNextPosition(int k, float speed, const sf::VertexArray &va);
-    void updateTrajectories(const DifferentialEvolver &evolver, const sf::Sprite &scenario, std::deque<Trajectory>& trajectories, sf::RenderTexture& offscreenStage);
+    void updateTrajectories(const PopulationSnapshot &population, const sf::Sprite &scenario, std::deque<Trajectory>& trajectories, sf::RenderTexture& offscreenStage);
     bool isInStage(const sf::Vector2f& point);
     void drawPane();
-    bool carCollides() const;
     void drawBorder(sf::RenderTexture &texture);
+    void adaptGenes(double* genes, unsigned int count) const;
 public:
     Window(int width, int height);
 
+    // Evaluates on a worker process as well; see EvaluationWorker.
+    bool connectWorker(const std::string& host, unsigned short port);
+
     bool loop();
 };
 